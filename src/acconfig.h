@@ -31,6 +31,9 @@
 /* Define this to embed DTrace probes */
 #undef USE_DTRACE
 
+/* Define this to embed the probes using <sys/sdt.h> */
+#undef USE_SDT
+
 /* Define this if you are going to use a memory access checker (like Purify) */
 #undef __CHECKER__
 
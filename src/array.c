@@ -732,6 +732,24 @@ static ptrdiff_t fast_array_search( struct array *v, const struct svalue *s,
 {
   ptrdiff_t e;
   struct svalue *ip = ITEM(v);
+
+  /* Homogeneous arrays of ints or floats don't need is_eq(). */
+  if ((v->type_field == BIT_INT) && (TYPEOF(*s) == T_INT)) {
+    INT_TYPE i = s->u.integer;
+    for(e=start;e<v->size;e++)
+      if(ip[e].u.integer == i)
+	return e;
+    return -1;
+  }
+  if ((v->type_field == BIT_FLOAT) && (TYPEOF(*s) == T_FLOAT)) {
+    FLOAT_TYPE f = s->u.float_number;
+    /* NB: NaN is never equal to anything, just like in is_eq(). */
+    for(e=start;e<v->size;e++)
+      if(ip[e].u.float_number == f)
+	return e;
+    return -1;
+  }
+
   for(e=start;e<v->size;e++)
     if(is_eq(ip+e,s))
       return e;
@@ -1335,12 +1353,36 @@ static int alpha_int_svalue_cmpfun(const struct svalue *a, const struct svalue *
 #undef TYPE
 #undef ID
 
+/* Same, but only floats. */
+static int alpha_float_svalue_cmpfun(const struct svalue *a,
+				     const struct svalue *b)
+{
+#ifdef PIKE_DEBUG
+  if ((TYPEOF(*a) != T_FLOAT) || (TYPEOF(*b) != T_FLOAT)) {
+    Pike_fatal("Invalid elements in supposedly float array.\n");
+  }
+#endif /* PIKE_DEBUG */
+  if(a->u.float_number < b->u.float_number) return -1;
+  if(a->u.float_number > b->u.float_number) return  1;
+  return 0;
+}
+
+#define CMP(X,Y) alpha_float_svalue_cmpfun(X,Y)
+#define TYPE struct svalue
+#define ID low_sort_float_svalues
+#include "fsort_template.h"
+#undef CMP
+#undef TYPE
+#undef ID
+
 /** This sort is unstable. */
 PMOD_EXPORT void sort_array_destructively(struct array *v)
 {
   if(!v->size) return;
   if (v->type_field == BIT_INT) {
     low_sort_int_svalues(ITEM(v), ITEM(v)+v->size-1);
+  } else if (v->type_field == BIT_FLOAT) {
+    low_sort_float_svalues(ITEM(v), ITEM(v)+v->size-1);
   } else {
     low_sort_svalues(ITEM(v), ITEM(v)+v->size-1);
   }
@@ -1361,12 +1403,31 @@ PMOD_EXPORT void sort_array_destructively(struct array *v)
 #define EXTRA_ARGS , struct svalue *svals, INT32 *pos, int size
 #define XARGS , svals, pos, size
 #include "fsort_template.h"
-#undef SORT_BY_INDEX
 #undef EXTRA_LOCALS
 #undef CMP
+#undef ID
+
+/* Same, but only integers. */
+#define CMP(X,Y) ((svals[X].u.integer < svals[Y].u.integer) ? -1 :	\
+		  (svals[X].u.integer > svals[Y].u.integer) ? 1 :	\
+		  pos[X] - pos[Y])
+#define ID low_stable_sort_int_svalues
+#include "fsort_template.h"
+#undef CMP
+#undef ID
+
+/* Same, but only floats. */
+#define CMP(X,Y) ((svals[X].u.float_number < svals[Y].u.float_number) ? -1 : \
+		  (svals[X].u.float_number > svals[Y].u.float_number) ? 1 : \
+		  pos[X] - pos[Y])
+#define ID low_stable_sort_float_svalues
+#include "fsort_template.h"
+#undef CMP
+#undef ID
+
+#undef SORT_BY_INDEX
 #undef SWAP
 #undef TYPE
-#undef ID
 #undef EXTRA_ARGS
 #undef XARGS
 
@@ -1385,7 +1446,15 @@ PMOD_EXPORT INT32 *stable_sort_array_destructively(struct array *v)
   SET_ONERROR(tmp, free, current_order);
   for(e=0; e<v->size; e++) current_order[e]=e;
 
-  low_stable_sort_svalues (0, v->size - 1, ITEM (v), current_order, v->size);
+  if (v->type_field == BIT_INT)
+    low_stable_sort_int_svalues (0, v->size - 1, ITEM (v), current_order,
+				 v->size);
+  else if (v->type_field == BIT_FLOAT)
+    low_stable_sort_float_svalues (0, v->size - 1, ITEM (v), current_order,
+				   v->size);
+  else
+    low_stable_sort_svalues (0, v->size - 1, ITEM (v), current_order,
+			     v->size);
 
   UNSET_ONERROR (tmp);
   return current_order;
@@ -1923,6 +1992,13 @@ PMOD_EXPORT int array_equal_p(struct array *a, struct array *b, struct processin
      !( (a->type_field | b->type_field) & (BIT_OBJECT|BIT_FUNCTION) ))
     return 0;
 
+  if ((a->type_field == BIT_INT) && (b->type_field == BIT_INT)) {
+    for(e=0; e<a->size; e++)
+      if(ITEM(a)[e].u.integer != ITEM(b)[e].u.integer)
+	return 0;
+    return 1;
+  }
+
   curr.pointer_a = a;
   curr.pointer_b = b;
   curr.next = p;
@@ -1978,6 +2054,115 @@ static int array_merge_fun(INT32 *a, INT32 *b,
   }
 }
 
+/* Large arrays containing only values that set_svalue_cmpfun()
+ * compares by identity are merged using a temporary hash table over
+ * the values in b, instead of by sorting both arrays.
+ */
+#define MERGE_HASH_MIN_SIZE	32
+#define MERGE_HASH_TYPES	(BIT_INT | BIT_STRING | BIT_ARRAY |	\
+				 BIT_MAPPING | BIT_MULTISET |		\
+				 BIT_PROGRAM | BIT_TYPE)
+
+struct merge_hash_entry
+{
+  struct svalue *val;	/* NULL if the slot is unused. */
+  INT32 count_a;	/* Number of occurrences in a so far. */
+  INT32 count_b;	/* Number of occurrences in b. */
+  INT32 seen_b;		/* Number of occurrences in b so far. */
+};
+
+static struct merge_hash_entry *merge_hash_lookup(struct merge_hash_entry *tab,
+						  size_t mask,
+						  const struct svalue *s)
+{
+  size_t h = hash_svalue(s) & mask;
+  while (tab[h].val) {
+    struct svalue *v = tab[h].val;
+    if ((TYPEOF(*v) == TYPEOF(*s)) &&
+	((TYPEOF(*s) == T_INT) ? (v->u.integer == s->u.integer) :
+	 (v->u.refs == s->u.refs)))
+      break;
+    h = (h + 1) & mask;
+  }
+  return tab + h;
+}
+
+/* Same result as merge_array_with_order() for the operations
+ * PIKE_ARRAY_OP_SUB, PIKE_ARRAY_OP_AND_LEFT, PIKE_ARRAY_OP_OR_LEFT and
+ * PIKE_ARRAY_OP_XOR, but in linear time.
+ *
+ * As with the sorted merge, the n:th occurrence of a value in one
+ * array is paired with the n:th occurrence in the other, and the
+ * selected elements of a are followed by those of b.
+ */
+static struct array *merge_array_with_hash(struct array *a,
+					   struct array *b, INT32 op)
+{
+  struct merge_hash_entry *tab, *ent;
+  size_t mask = 15;
+  char *take;
+  INT32 e, size = 0;
+  struct array *ret;
+  TYPE_FIELD types = 0;
+  ONERROR r1, r2;
+
+  while (mask < (size_t)b->size * 2) mask = mask * 2 + 1;
+  tab = xcalloc(mask + 1, sizeof(struct merge_hash_entry));
+  SET_ONERROR(r1, free, tab);
+  take = xalloc(a->size + b->size + 1);
+  SET_ONERROR(r2, free, take);
+
+  for (e = 0; e < b->size; e++) {
+    ent = merge_hash_lookup(tab, mask, ITEM(b) + e);
+    ent->val = ITEM(b) + e;
+    ent->count_b++;
+  }
+
+  for (e = 0; e < a->size; e++) {
+    INT32 k = 0, count_b = 0;
+    ent = merge_hash_lookup(tab, mask, ITEM(a) + e);
+    if (ent->val) {
+      k = ent->count_a++;
+      count_b = ent->count_b;
+    }
+    switch(op) {
+    case PIKE_ARRAY_OP_SUB:      take[e] = !count_b; break;
+    case PIKE_ARRAY_OP_AND_LEFT: take[e] = (k < count_b); break;
+    case PIKE_ARRAY_OP_XOR:      take[e] = (k >= count_b); break;
+    default:                     take[e] = 1; break;
+    }
+    size += take[e];
+  }
+
+  for (e = 0; e < b->size; e++) {
+    if ((op == PIKE_ARRAY_OP_OR_LEFT) || (op == PIKE_ARRAY_OP_XOR)) {
+      ent = merge_hash_lookup(tab, mask, ITEM(b) + e);
+      take[a->size + e] = (ent->seen_b++ >= ent->count_a);
+    } else {
+      take[a->size + e] = 0;
+    }
+    size += take[a->size + e];
+  }
+
+  ret = allocate_array_no_init(size, 0);
+  size = 0;
+  for (e = 0; e < a->size; e++) {
+    if (!take[e]) continue;
+    assign_svalue_no_free(ITEM(ret) + size++, ITEM(a) + e);
+    types |= 1 << TYPEOF(ITEM(a)[e]);
+  }
+  for (e = 0; e < b->size; e++) {
+    if (!take[a->size + e]) continue;
+    assign_svalue_no_free(ITEM(ret) + size++, ITEM(b) + e);
+    types |= 1 << TYPEOF(ITEM(b)[e]);
+  }
+  if (size) ret->type_field = types;
+
+  CALL_AND_UNSET_ONERROR(r2);
+  CALL_AND_UNSET_ONERROR(r1);
+  return ret;
+}
+
 /**
  * Merge two arrays and retain their order. This is done by arranging them
  * into ordered sets, merging them as sets and then rearranging the zipper
@@ -1991,6 +2176,12 @@ PMOD_EXPORT struct array *merge_array_with_order(struct array *a,
   struct array *tmpa,*tmpb,*ret;
   INT32 *ordera, *orderb;
 
+  if ((a->size + b->size >= MERGE_HASH_MIN_SIZE) &&
+      !((a->type_field | b->type_field) & ~MERGE_HASH_TYPES) &&
+      ((op == PIKE_ARRAY_OP_SUB) || (op == PIKE_ARRAY_OP_AND_LEFT) ||
+       (op == PIKE_ARRAY_OP_OR_LEFT) || (op == PIKE_ARRAY_OP_XOR)))
+    return merge_array_with_hash(a, b, op);
+
   ordera=get_set_order(a);
   SET_ONERROR(r4,free,ordera);
 
@@ -2168,6 +2168,7 @@ void ins_f_byte(unsigned int b)
     }
     return;
   case F_MULTIPLY:
+  case F_MULTIPLY_INTS:
     {
       LABELS();
       if_not_two_int(&label_C,1);
@@ -2644,6 +2645,7 @@ void ins_f_byte(unsigned int b)
     return;
 
   case F_SUBTRACT:
+  case F_SUBTRACT_INTS:
     {
     LABELS();
     ins_debug_instr_prologue(b, 0, 0);
@@ -1881,6 +1881,7 @@ static void low_ins_f_byte(unsigned int opcode)
       arm32_call_efun(f_add, 2);
       return;
   case F_ADD_INTS:
+  case F_SUBTRACT_INTS:
       {
           struct label end, slow;
           enum arm32_register reg1, reg2;
@@ -1905,7 +1906,10 @@ static void low_ins_f_byte(unsigned int opcode)
           load32_reg_imm(reg1, ARM_REG_PIKE_SP, -2*sizeof(struct svalue)+OFFSETOF(svalue, u));
           load32_reg_imm(reg2, ARM_REG_PIKE_SP, -1*sizeof(struct svalue)+OFFSETOF(svalue, u));
 
-          adds_reg_reg(reg1, reg1, reg2);
+          if (opcode == F_ADD_INTS)
+            adds_reg_reg(reg1, reg1, reg2);
+          else
+            subs_reg_reg(reg1, reg1, reg2);
 
           add_to_program(
             set_cond(
@@ -1917,10 +1921,14 @@ static void low_ins_f_byte(unsigned int opcode)
 
           b_imm(label_dist(&end), ARM_COND_VC);
           label_generate(&slow);
-          ra_alloc(ARM_REG_ARG1);
-          arm32_mov_int(ARM_REG_ARG1, 2);
-          arm32_call(f_add);
-          ra_free(ARM_REG_ARG1);
+          if (opcode == F_ADD_INTS) {
+            ra_alloc(ARM_REG_ARG1);
+            arm32_mov_int(ARM_REG_ARG1, 2);
+            arm32_call(f_add);
+            ra_free(ARM_REG_ARG1);
+          } else {
+            arm32_call(o_subtract);
+          }
           label_generate(&end);
           arm32_sub_reg_int(ARM_REG_PIKE_SP, ARM_REG_PIKE_SP, sizeof(struct svalue));
           arm32_store_sp_reg();
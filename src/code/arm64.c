@@ -2351,6 +2351,7 @@ static void low_ins_f_byte(unsigned int opcode)
       arm64_call_efun(f_add, 2);
       return;
   case F_ADD_INTS:
+  case F_SUBTRACT_INTS:
       {
           struct label end, slow;
           enum arm64_register reg1, reg2;
@@ -2376,9 +2377,15 @@ static void low_ins_f_byte(unsigned int opcode)
           load_svalue_int(reg2, ARM_REG_PIKE_SP, -1*(INT32)sizeof(struct svalue));
 
 #if SIZEOF_INT_TYPE == 4
-          adds32_reg_reg(reg1, reg1, reg2);
+          if (opcode == F_ADD_INTS)
+            adds32_reg_reg(reg1, reg1, reg2);
+          else
+            subs32_reg_reg(reg1, reg1, reg2);
 #else
-          adds64_reg_reg(reg1, reg1, reg2);
+          if (opcode == F_ADD_INTS)
+            adds64_reg_reg(reg1, reg1, reg2);
+          else
+            subs64_reg_reg(reg1, reg1, reg2);
 #endif
 
 	  b_imm_cond(label_dist(&slow), ARM_COND_VS);
@@ -2390,10 +2397,14 @@ static void low_ins_f_byte(unsigned int opcode)
 
           b_imm(label_dist(&end));
           label_generate(&slow);
-          ra_alloc(ARM_REG_ARG1);
-          arm64_mov_int(ARM_REG_ARG1, 2);
-          arm64_call(f_add);
-          ra_free(ARM_REG_ARG1);
+          if (opcode == F_ADD_INTS) {
+            ra_alloc(ARM_REG_ARG1);
+            arm64_mov_int(ARM_REG_ARG1, 2);
+            arm64_call(f_add);
+            ra_free(ARM_REG_ARG1);
+          } else {
+            arm64_call(o_subtract);
+          }
           label_generate(&end);
           arm64_sub64_reg_int(ARM_REG_PIKE_SP, ARM_REG_PIKE_SP, sizeof(struct svalue));
           arm64_store_sp_reg();
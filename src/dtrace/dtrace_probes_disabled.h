@@ -4,3 +4,17 @@
 #define PIKE_FN_POPFRAME()
 #define PIKE_FN_DONE_ENABLED() 0
 #define PIKE_FN_DONE(arg0)
+#define PIKE_GC_START_ENABLED() 0
+#define PIKE_GC_START()
+#define PIKE_GC_DONE_ENABLED() 0
+#define PIKE_GC_DONE(arg0)
+#define PIKE_COMPILE_START_ENABLED() 0
+#define PIKE_COMPILE_START()
+#define PIKE_COMPILE_DONE_ENABLED() 0
+#define PIKE_COMPILE_DONE(arg0, arg1)
+#define PIKE_BACKEND_ITERATION_ENABLED() 0
+#define PIKE_BACKEND_ITERATION(arg0)
+#define PIKE_INTERPRETER_LOCK_ENABLED() 0
+#define PIKE_INTERPRETER_LOCK()
+#define PIKE_INTERPRETER_UNLOCK_ENABLED() 0
+#define PIKE_INTERPRETER_UNLOCK()
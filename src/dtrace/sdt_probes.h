@@ -0,0 +1,60 @@
+/*
+ * The probes in dtrace_probes.d, implemented with <sys/sdt.h> from
+ * systemtap. They can be used with perf, bpftrace and systemtap on
+ * Linux, without running dtrace -G at link time.
+ *
+ * The semaphores are defined in the file that defines
+ * PIKE_DEFINE_PROBE_SEMAPHORES before including this file.
+ */
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#ifdef PIKE_DEFINE_PROBE_SEMAPHORES
+#define PIKE_PROBE_SEMAPHORE(NAME)					\
+  unsigned short pike_##NAME##_semaphore				\
+  __attribute__((section(".probes")))
+#else
+#define PIKE_PROBE_SEMAPHORE(NAME)					\
+  extern unsigned short pike_##NAME##_semaphore
+#endif
+
+PIKE_PROBE_SEMAPHORE(fn__start);
+PIKE_PROBE_SEMAPHORE(fn__popframe);
+PIKE_PROBE_SEMAPHORE(fn__done);
+PIKE_PROBE_SEMAPHORE(gc__start);
+PIKE_PROBE_SEMAPHORE(gc__done);
+PIKE_PROBE_SEMAPHORE(compile__start);
+PIKE_PROBE_SEMAPHORE(compile__done);
+PIKE_PROBE_SEMAPHORE(backend__iteration);
+PIKE_PROBE_SEMAPHORE(interpreter__lock);
+PIKE_PROBE_SEMAPHORE(interpreter__unlock);
+
+#define PIKE_PROBE_ENABLED(NAME)					\
+  __builtin_expect(pike_##NAME##_semaphore, 0)
+
+#define PIKE_FN_START_ENABLED() PIKE_PROBE_ENABLED(fn__start)
+#define PIKE_FN_START(arg0, arg1) STAP_PROBE2(pike, fn__start, arg0, arg1)
+#define PIKE_FN_POPFRAME_ENABLED() PIKE_PROBE_ENABLED(fn__popframe)
+#define PIKE_FN_POPFRAME() STAP_PROBE(pike, fn__popframe)
+#define PIKE_FN_DONE_ENABLED() PIKE_PROBE_ENABLED(fn__done)
+#define PIKE_FN_DONE(arg0) STAP_PROBE1(pike, fn__done, arg0)
+#define PIKE_GC_START_ENABLED() PIKE_PROBE_ENABLED(gc__start)
+#define PIKE_GC_START() STAP_PROBE(pike, gc__start)
+#define PIKE_GC_DONE_ENABLED() PIKE_PROBE_ENABLED(gc__done)
+#define PIKE_GC_DONE(arg0) STAP_PROBE1(pike, gc__done, arg0)
+#define PIKE_COMPILE_START_ENABLED() PIKE_PROBE_ENABLED(compile__start)
+#define PIKE_COMPILE_START() STAP_PROBE(pike, compile__start)
+#define PIKE_COMPILE_DONE_ENABLED() PIKE_PROBE_ENABLED(compile__done)
+#define PIKE_COMPILE_DONE(arg0, arg1)					\
+  STAP_PROBE2(pike, compile__done, arg0, arg1)
+#define PIKE_BACKEND_ITERATION_ENABLED()				\
+  PIKE_PROBE_ENABLED(backend__iteration)
+#define PIKE_BACKEND_ITERATION(arg0)					\
+  STAP_PROBE1(pike, backend__iteration, arg0)
+#define PIKE_INTERPRETER_LOCK_ENABLED()				\
+  PIKE_PROBE_ENABLED(interpreter__lock)
+#define PIKE_INTERPRETER_LOCK() STAP_PROBE(pike, interpreter__lock)
+#define PIKE_INTERPRETER_UNLOCK_ENABLED()				\
+  PIKE_PROBE_ENABLED(interpreter__unlock)
+#define PIKE_INTERPRETER_UNLOCK() STAP_PROBE(pike, interpreter__unlock)
@@ -28,6 +28,7 @@ struct callback *gc_evaluator_callback=0;
 #include "main.h"
 #include "builtin_functions.h"
 #include "block_allocator.h"
+#include "pike_probes.h"
 
 #include <math.h>
 
@@ -3524,6 +3525,8 @@ size_t do_gc(int explicit_call)
     pop_stack();
   }
 
+  PIKE_GC_START();
+
   gc_start_time = get_cpu_time();
   gc_start_real_time = get_real_time();
 #ifdef GC_DEBUG
@@ -4185,6 +4188,8 @@ size_t do_gc(int explicit_call)
     return destruct_count;
 #endif
 
+  PIKE_GC_DONE((long)unreferenced);
+
   if (!SAFE_IS_ZERO(&gc_done_cb)) {
     push_int(unreferenced);
     safe_apply_svalue(&gc_done_cb, 1, 1);
@@ -47,11 +47,8 @@
 #endif
 #endif
 
-#ifdef USE_DTRACE
-#include "dtrace_probes.h"
-#else
-#include "dtrace/dtrace_probes_disabled.h"
-#endif
+#define PIKE_DEFINE_PROBE_SEMAPHORES
+#include "pike_probes.h"
 
 /*
  * Define the default evaluator stack size, used for just about everything.
@@ -1951,6 +1951,59 @@ OPCODE0_ALIAS(F_MULTIPLY, "*", I_UPDATE_SP, o_multiply);
 OPCODE0_ALIAS(F_DIVIDE, "/", I_UPDATE_SP, o_divide);
 OPCODE0_ALIAS(F_MOD, "%", I_UPDATE_SP, o_mod);
 
+/* The following are emitted by generate_minus() and generate_multiply()
+ * when the types of both operands are known. They fall back to the
+ * generic operator if the types turn out to be wrong, or on overflow.
+ */
+OPCODE0(F_SUBTRACT_INTS, "int-int", I_UPDATE_SP, {
+  if(TYPEOF(Pike_sp[-1]) == T_INT && TYPEOF(Pike_sp[-2]) == T_INT
+     && !INT_TYPE_SUB_OVERFLOW(Pike_sp[-2].u.integer, Pike_sp[-1].u.integer))
+  {
+    Pike_sp[-2].u.integer-=Pike_sp[-1].u.integer;
+    SET_SVAL_SUBTYPE(Pike_sp[-2], NUMBER_NUMBER);
+    dmalloc_touch_svalue(Pike_sp-1);
+    Pike_sp--;
+  }else{
+    o_subtract();
+  }
+});
+
+OPCODE0(F_SUBTRACT_FLOATS, "float-float", I_UPDATE_SP, {
+  if(TYPEOF(Pike_sp[-1]) == T_FLOAT && TYPEOF(Pike_sp[-2]) == T_FLOAT)
+  {
+    Pike_sp[-2].u.float_number-=Pike_sp[-1].u.float_number;
+    dmalloc_touch_svalue(Pike_sp-1);
+    Pike_sp--;
+  }else{
+    o_subtract();
+  }
+});
+
+OPCODE0(F_MULTIPLY_INTS, "int*int", I_UPDATE_SP, {
+  INT_TYPE res;
+  if(TYPEOF(Pike_sp[-1]) == T_INT && TYPEOF(Pike_sp[-2]) == T_INT
+     && !DO_INT_TYPE_MUL_OVERFLOW(Pike_sp[-2].u.integer,
+				  Pike_sp[-1].u.integer, &res))
+  {
+    SET_SVAL(Pike_sp[-2], T_INT, NUMBER_NUMBER, integer, res);
+    dmalloc_touch_svalue(Pike_sp-1);
+    Pike_sp--;
+  }else{
+    o_multiply();
+  }
+});
+
+OPCODE0(F_MULTIPLY_FLOATS, "float*float", I_UPDATE_SP, {
+  if(TYPEOF(Pike_sp[-1]) == T_FLOAT && TYPEOF(Pike_sp[-2]) == T_FLOAT)
+  {
+    Pike_sp[-2].u.float_number*=Pike_sp[-1].u.float_number;
+    dmalloc_touch_svalue(Pike_sp-1);
+    Pike_sp--;
+  }else{
+    o_multiply();
+  }
+});
+
 OPCODE1(F_SUBTRACT_INT, "- int", 0, {
     push_int( arg1 );
     o_subtract();
@@ -974,6 +974,14 @@ static int low_yylex(struct lex *lex, YYSTYPE *yylval)
           {
             lex->pragmas &= ~ID_DYNAMIC_DOT;
           }
+          else if (ISWORD("no_inline_calls"))
+          {
+            lex->pragmas |= ID_NO_INLINE_CALLS;
+          }
+          else if (ISWORD("inline_calls"))
+          {
+            lex->pragmas &= ~ID_NO_INLINE_CALLS;
+          }
           else if (ISWORD("compiler_trace"))
           {
             lex->pragmas |= ID_COMPILER_TRACE;
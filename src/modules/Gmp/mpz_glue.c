@@ -2354,10 +2354,25 @@ static void mpzmod__size_object(INT32 UNUSED(args))
   push_int(ALIMBS(THIS) * sizeof(mp_limb_t) + sizeof(mpz_t));
 }
 
+/* Arithmetic that overflows the native integers creates and frees
+ * lots of small mpz objects. Keep a cache of zeroed mpz_t with small
+ * limb buffers, so that they can be reused without a round trip
+ * through malloc() and free().
+ *
+ * NB: Only accessed with the interpreter lock held.
+ */
+#define MPZ_CACHE_SIZE		256
+#define MPZ_CACHE_MAX_LIMBS	4
+static MP_INT mpz_cache[MPZ_CACHE_SIZE];
+static int mpz_cache_count = 0;
+
 static void init_mpz_glue(struct object * UNUSED(o))
 {
   DECLARE_THIS();
-  mpz_init(THIS);
+  if (mpz_cache_count)
+    *THIS = mpz_cache[--mpz_cache_count];
+  else
+    mpz_init(THIS);
 }
 
 static void exit_mpz_glue(struct object *UNUSED(o))
@@ -2365,7 +2380,12 @@ static void exit_mpz_glue(struct object *UNUSED(o))
   DECLARE_THIS();
   if( THIS_OBJECT->flags & OBJECT_CLEAR_ON_EXIT )
     memset(LIMBS(THIS), 0, ALIMBS(THIS) * sizeof(mp_limb_t));
-  mpz_clear(THIS);
+  if ((ALIMBS(THIS) > 0) && (ALIMBS(THIS) <= MPZ_CACHE_MAX_LIMBS) &&
+      (mpz_cache_count < MPZ_CACHE_SIZE)) {
+    mpz_set_ui(THIS, 0);
+    mpz_cache[mpz_cache_count++] = *THIS;
+  } else
+    mpz_clear(THIS);
 }
 
 static void gc_recurse_mpz (struct object *o)
@@ -2589,6 +2609,9 @@ PIKE_MODULE_EXIT
   free_program(bignum_program);
   bignum_program = NULL;
 
+  while (mpz_cache_count)
+    mpz_clear(mpz_cache + --mpz_cache_count);
+
   mpz_clear (mpz_int_type_min);
 #if SIZEOF_INT64 != SIZEOF_LONG || SIZEOF_INT_TYPE != SIZEOF_LONG 
   mpz_clear (mpz_int64_min);
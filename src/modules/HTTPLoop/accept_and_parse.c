@@ -307,13 +307,30 @@ void aap_handle_connection(struct args *arg)
 
   if(arg->res.leftovers && arg->res.leftovers_len)
   {
-    buffer_len = arg->res.leftovers_len;
-    memcpy(buffer, arg->res.leftovers, arg->res.leftovers_len);
+    /* Pipelined requests. The leftovers normally live in the same
+     * buffer that we are reusing, so they may overlap the start of
+     * it. Keep the full buffer size, so that the rest of a partial
+     * request can be read after them.
+     */
+    if(arg->res.leftovers_len > buffer_len)
+    {
+      buffer_len = arg->res.leftovers_len;
+      buffer = xrealloc(buffer, buffer_len);
+      p = buffer;
+    }
+    memmove(buffer, arg->res.leftovers, arg->res.leftovers_len);
     pos = arg->res.leftovers_len;
     arg->res.leftovers=0;
+    arg->res.leftovers_len=0;
     if((tmp = my_memmem("\r\n\r\n", 4, buffer, pos)))
       goto ok;
-    p += arg->res.leftovers_len;
+    p += pos;
+    if(pos >= buffer_len)
+    {
+      buffer_len *= 2;
+      buffer = xrealloc(buffer, buffer_len);
+      p = buffer+pos;
+    }
   }
 
 #ifdef HAVE_TIMEOUTS
@@ -559,6 +576,16 @@ static void finished_p(struct callback *UNUSED(foo), void *UNUSED(b), void *UNUS
  *! @[keep_log] indicates if a log of all requests should be kept.
  *! @[timeout] if non-zero indicates a maximum time the server will wait for requests.
  *!
+ *! HTTP/1.1 clients may pipeline several requests on a kept-alive
+ *! connection; they are handled, and answered, in order. Requests
+ *! that hit the cache are answered directly by the accept threads,
+ *! without involving the interpreter.
+ *!
+ *! @note
+ *!   The @[port] is serviced by several threads. To spread the
+ *!   load over several listen queues, bind multiple ports with
+ *!   @expr{reuse_port@} (see @[Stdio.Port()->bind()]) and create
+ *!   a @[Loop] for each.
 */
 static void f_accept_with_http_parse(INT32 nargs)
 {
@@ -274,8 +274,11 @@ struct cache_entry *aap_cache_lookup(char *s, ptrdiff_t len,
 	e->next = c->htable[h];
 	c->htable[h] = e;
       }
-      if(!nolock) mt_unlock(&c->mutex);
+      /* NB: The reference must be added while the entry is locked,
+       *     or it may be freed by another thread before we use it.
+       */
       e->refs++;
+      if(!nolock) mt_unlock(&c->mutex);
       return e;
     }
     prev = e;
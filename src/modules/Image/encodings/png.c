@@ -1064,6 +1064,21 @@ static int _png_decode_idat(struct IHDR *ihdr, struct neo_colortable *ct,
 	       ihdr->width, ihdr->height);
   }
 
+  if (!ihdr->interlace)
+  {
+    /* Unfilter before allocating the image, and replace the
+     * decompressed data on the stack with the result, so that
+     * it is released before the image is allocated.
+     */
+    fs = sp[-1].u.string;
+    fs=_png_unfilter((unsigned char*)fs->str,fs->len,
+                     ihdr->width,ihdr->height,
+                     ihdr->filter,ihdr->type,ihdr->bpp,
+                     NULL);
+    pop_stack();
+    push_string(fs);
+  }
+
   if( got_alpha )
     wa1=xalloc(sizeof(rgb_group)*ihdr->width*ihdr->height + RGB_VEC_PAD);
   SET_ONERROR(a_err, free_and_clear, &wa1);
@@ -1077,20 +1092,13 @@ static int _png_decode_idat(struct IHDR *ihdr, struct neo_colortable *ct,
   switch (ihdr->interlace)
   {
   case 0: /* none */
-    fs=_png_unfilter((unsigned char*)fs->str,fs->len,
-                     ihdr->width,ihdr->height,
-                     ihdr->filter,ihdr->type,ihdr->bpp,
-                     NULL);
-
-    push_string(fs);
-
+    /* Already unfiltered above. */
     _png_write_rgb(w1,wa1,
                    ihdr->type,ihdr->bpp,
                    (unsigned char*)fs->str,fs->len,
                    ihdr->width,
                    ihdr->width*ihdr->height,
                    ct,trns);
-    pop_stack();
     break;
 
   case 1: /* adam7 */
@@ -2360,14 +2360,33 @@ void image_grey(INT32 args)
    s=THIS->img;
    x=THIS->xsize*THIS->ysize;
    THREADS_ALLOW();
-   while (x--)
+   if (rgb.r>=0 && rgb.g>=0 && rgb.b>=0 && div>0 && div<=0x1010101)
    {
-      d->r=d->g=d->b=
-	 testrange( ((((long)s->r)*rgb.r+
-		      ((long)s->g)*rgb.g+
-		      ((long)s->b)*rgb.b)/div) );
-      d++;
-      s++;
+      /* The common case; the weighted sum fits in 32 bits and the
+       * result is always in range, so avoid a division per pixel.
+       */
+      struct image_divisor q;
+      unsigned INT32 wr=rgb.r, wg=rgb.g, wb=rgb.b;
+      image_divisor_init(&q, div);
+      while (x--)
+      {
+	 d->r=d->g=d->b=
+	    (COLORTYPE)image_divide(s->r*wr+s->g*wg+s->b*wb, &q);
+	 d++;
+	 s++;
+      }
+   }
+   else
+   {
+      while (x--)
+      {
+	 d->r=d->g=d->b=
+	    testrange( ((((long)s->r)*rgb.r+
+			 ((long)s->g)*rgb.g+
+			 ((long)s->b)*rgb.b)/div) );
+	 d++;
+	 s++;
+      }
    }
    THREADS_DISALLOW();
    pop_n_elems(args);
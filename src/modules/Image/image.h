@@ -47,6 +47,36 @@ static inline int absdiff(int a, int b)
   return a<b?(b-a):(a-b);
 }
 
+/* Exact unsigned division by a divisor that is only known at runtime,
+ * but is the same for every pixel. The division is replaced by a
+ * multiplication and two shifts, which gives the same result as "/"
+ * for all 32-bit dividends (Granlund & Montgomery, "Division by
+ * invariant integers using multiplication", PLDI 1994).
+ */
+struct image_divisor
+{
+   unsigned INT32 m;
+   int s1, s2;
+};
+
+static inline void image_divisor_init(struct image_divisor *d,
+				      unsigned INT32 div)
+{
+   int l = 0;
+   while (l < 32 && (((UINT64)1) << l) < div) l++;
+   d->m = (unsigned INT32)(((((UINT64)1) << l) - div) * (((UINT64)1) << 32) /
+			   div + 1);
+   d->s1 = l ? 1 : 0;
+   d->s2 = l ? l - 1 : 0;
+}
+
+static inline unsigned INT32 image_divide(unsigned INT32 n,
+					  const struct image_divisor *d)
+{
+   unsigned INT32 t = (unsigned INT32)((((UINT64)n) * d->m) >> 32);
+   return (t + ((n - t) >> d->s1)) >> d->s2;
+}
+
 #define pixel(_img,x,y) ((_img)->img[((int)(x))+((int)(y))*(int)(_img)->xsize])
 
 #define apply_alpha(x,y,alpha) \
@@ -236,26 +236,29 @@ void img_scale2(struct image *dest, struct image *source)
    newx -= source->xsize & 1;
    newy -= source->ysize & 1;
 
-   /* The base case. */
+   /* The base case.
+    *
+    * Work a destination row at a time from two source rows, so that
+    * the inner loop is a plain walk over three pointers.
+    */
    for (y = 0; y < newy; y++)
-      for (x = 0; x < newx; x++)
+   {
+      rgb_group *s0 = source->img + 2*y*source->xsize;
+      rgb_group *s1 = s0 + source->xsize;
+      rgb_group *d = dest->img + y*dest->xsize;
+      for (x = 0; x < newx; x++, s0 += 2, s1 += 2, d++)
       {
-	 pixel(dest,x,y).r = (COLORTYPE)
-	    (((INT32) pixel(source,2*x+0,2*y+0).r+
-	      (INT32) pixel(source,2*x+1,2*y+0).r+
-	      (INT32) pixel(source,2*x+0,2*y+1).r+
-	      (INT32) pixel(source,2*x+1,2*y+1).r) >> 2);
-	 pixel(dest,x,y).g = (COLORTYPE)
-	    (((INT32) pixel(source,2*x+0,2*y+0).g+
-	      (INT32) pixel(source,2*x+1,2*y+0).g+
-	      (INT32) pixel(source,2*x+0,2*y+1).g+
-	      (INT32) pixel(source,2*x+1,2*y+1).g) >> 2);
-	 pixel(dest,x,y).b = (COLORTYPE)
-	    (((INT32) pixel(source,2*x+0,2*y+0).b+
-	      (INT32) pixel(source,2*x+1,2*y+0).b+
-	      (INT32) pixel(source,2*x+0,2*y+1).b+
-	      (INT32) pixel(source,2*x+1,2*y+1).b) >> 2);
+	 d->r = (COLORTYPE)
+	    (((INT32)s0[0].r + (INT32)s0[1].r +
+	      (INT32)s1[0].r + (INT32)s1[1].r) >> 2);
+	 d->g = (COLORTYPE)
+	    (((INT32)s0[0].g + (INT32)s0[1].g +
+	      (INT32)s1[0].g + (INT32)s1[1].g) >> 2);
+	 d->b = (COLORTYPE)
+	    (((INT32)s0[0].b + (INT32)s0[1].b +
+	      (INT32)s1[0].b + (INT32)s1[1].b) >> 2);
       }
+   }
    /* X edge. */
    if (source->xsize & 1) {
      for (y = 0; y < newy; y++) {
@@ -16,6 +16,8 @@
 #include "builtin_functions.h"
 #include "module_support.h"
 #include "pike_types.h"
+#include "pike_threads.h"
+#include "pike_macros.h"
 
 #include "math_module.h"
 
@@ -32,6 +34,16 @@
  *! Matrix representation with double precision floating point values.
  */
 
+/* Side of the square blocks that matrix multiplication works on.
+ * Three blocks of 64x64 doubles fit in a typical L2 cache.
+ */
+#define MATRIX_BLOCK	64
+
+/* Number of multiply-adds above which the interpreter lock is
+ * released during matrix multiplication.
+ */
+#define MATRIX_MULT_THREADS_LIMIT	100000.0
+
 static struct pike_string *s__clr;
 static struct pike_string *s_identity;
 static struct pike_string *s_rotate;
@@ -397,7 +397,7 @@ static inline struct matrixX(_storage)
 static void matrixX(_transpose)(INT32 args)
 {
    struct matrixX(_storage) *mx;
-   int x,y,xs,ys;
+   int x,y,xs,ys,xx,yy,xe,ye;
    FTYPE *s,*d;
 
    pop_n_elems(args);
@@ -408,13 +408,19 @@ static void matrixX(_transpose)(INT32 args)
    s=THIS->m;
    d=mx->m;
 
-   y=xs;
-   while (y--)
+   /* Work in blocks, so that neither the reads nor the writes
+    * stride through the whole matrix for every element.
+    */
+   for (yy=0; yy<ys; yy+=MATRIX_BLOCK)
    {
-      x=ys;
-      while (x--)
-	 *(d++)=*s,s+=xs;
-      s-=xs*ys-1;
+      ye=MINIMUM(yy+MATRIX_BLOCK,ys);
+      for (xx=0; xx<xs; xx+=MATRIX_BLOCK)
+      {
+	 xe=MINIMUM(xx+MATRIX_BLOCK,xs);
+	 for (x=xx; x<xe; x++)
+	    for (y=yy; y<ye; y++)
+	       d[x*ys+y]=s[y*xs+x];
+      }
    }
 }
 
@@ -629,12 +635,39 @@ static void matrixX(_min)(INT32 args)
 
 
 
+static void matrixX(_gemm)(FTYPE *d, const FTYPE *a, const FTYPE *b,
+			   int m, int n, int p)
+{
+   int i,j,k,jj,kk,je,ke;
+
+   for (kk=0; kk<p; kk+=MATRIX_BLOCK)
+   {
+      ke=MINIMUM(kk+MATRIX_BLOCK,p);
+      for (jj=0; jj<n; jj+=MATRIX_BLOCK)
+      {
+	 je=MINIMUM(jj+MATRIX_BLOCK,n);
+	 for (i=0; i<m; i++)
+	 {
+	    FTYPE *dr=d+i*p;
+	    const FTYPE *ar=a+i*n;
+	    for (j=jj; j<je; j++)
+	    {
+	       FTYPE z=ar[j];
+	       const FTYPE *br=b+j*p;
+	       for (k=kk; k<ke; k++)
+		  dr[k] += z*br[k];
+	    }
+	 }
+      }
+   }
+}
+
 static void matrixX(_mult)(INT32 args)
 {
    struct matrixX(_storage) *mx=NULL;
    struct matrixX(_storage) *dmx;
-   int n,i,j,k,m,p;
-   FTYPE *s1,*s2,*d,*st;
+   int n,i,m,p;
+   FTYPE *s1,*s2,*d;
    FTYPE z;
 
    if (args<1)
@@ -679,28 +712,36 @@ scalar_mult:
        !((mx=get_storage(Pike_sp[-1].u.object,XmatrixY(math_,_program)))))
       SIMPLE_ARG_TYPE_ERROR("`*",1,"object(Math.Matrix)");
 
-   if (mx->xsize != THIS->ysize)
+   if (mx->ysize != THIS->xsize)
       math_error("`*",args,0,
 		 "Incompatible matrices.\n");
 
-   m=THIS->xsize;
-   n=THIS->ysize; /* == mx->xsize */
-   p=mx->ysize;
+   m=THIS->ysize;
+   n=THIS->xsize; /* == mx->ysize */
+   p=mx->xsize;
 
    dmx=matrixX(_push_new_)(p,m);
 
-   s1=mx->m;
-   s2=THIS->m;
+   s1=THIS->m;
+   s2=mx->m;
    d=dmx->m;
-   for (k=0; k<p; k++)
-      for (i=0; i<m; i++)
-      {
-	 z=(FTYPE)0;
-	 st=s2+k*n;
-	 for (j=i; j<i+m*n; j+=m)
-	    z += s1[ j ] * *(st++);
-	 *(d++)=z;
-      }
+
+   /* d[i][k] = sum(s1[i][j] * s2[j][k]) for j = 0..n-1
+    *
+    * Loop in i, j, k order over blocks of j and k, so that the inner
+    * loop walks rows of s2 and d sequentially and the blocks of s2
+    * stay in cache. Every element still gets its terms added in
+    * increasing j order, so the result is the same as that of the
+    * plain dot products. The result starts out cleared.
+    */
+   if ((double)m*n*p > MATRIX_MULT_THREADS_LIMIT)
+   {
+      THREADS_ALLOW();
+      matrixX(_gemm)(d,s1,s2,m,n,p);
+      THREADS_DISALLOW();
+   }
+   else
+      matrixX(_gemm)(d,s1,s2,m,n,p);
 
    stack_swap();
    pop_stack();
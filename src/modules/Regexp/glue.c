@@ -67,7 +67,7 @@ static void do_free(void)
 {
   if(THIS->regexp)
   {
-    free(THIS->regexp);
+    pike_regfree(THIS->regexp);
     THIS->regexp=0;
   }
 }
@@ -102,10 +102,10 @@ static void regexp_create(INT32 args)
  *! Returns an array containing strings in @[strs] that match the
  *! regexp bound to the regexp object.
  *!
- *! @bugs
- *!   The current implementation doesn't support searching
- *!   in strings containing the NUL character or any
- *!   wide character.
+ *! @note
+ *!   Matching takes time linear in the length of the string. The
+ *!   regexp is run as a DFA, which is built lazily and cached in
+ *!   the regexp object.
  *!
  *! @seealso
  *!   @[split]
@@ -120,10 +120,9 @@ static void regexp_match(INT32 args)
 
   if(TYPEOF(Pike_sp[-args]) == T_STRING)
   {
-    if(Pike_sp[-args].u.string->size_shift)
-      SIMPLE_ARG_TYPE_ERROR("match", 1, "string(8bit)");
+    struct pike_string *s = Pike_sp[-args].u.string;
 
-    i = pike_regexec(regexp, (char *)STR0(Pike_sp[-args].u.string));
+    i = pike_regmatch(regexp, MKPCHARP_STR(s), s->len);
     pop_n_elems(args);
     push_int(i);
     return;
@@ -139,10 +138,11 @@ static void regexp_match(INT32 args)
     {
       struct svalue *sv = ITEM(arr) + i;
 
-      if(TYPEOF(*sv) != T_STRING || sv->u.string->size_shift)
-	SIMPLE_ARG_TYPE_ERROR("match", 1, "string(8bit)");
+      if(TYPEOF(*sv) != T_STRING)
+	SIMPLE_ARG_TYPE_ERROR("match", 1, "array(string)");
 
-      if(pike_regexec(regexp, (char *)STR0(sv->u.string)))
+      if(pike_regmatch(regexp, MKPCHARP_STR(sv->u.string),
+                       sv->u.string->len))
       {
 	ref_push_string(sv->u.string);
 	n++;
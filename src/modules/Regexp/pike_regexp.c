@@ -69,6 +69,7 @@
 #include "pike_memory.h"
 #include "pike_error.h"
 #include "interpret.h"
+#include "stralloc.h"
 
 #undef NOTHING
 
@@ -323,6 +324,9 @@ regexp *pike_regcomp(const char *exp)
     goto exit_regcomp;
   }
 
+  r->regplen = regsize;
+  r->dfa = NULL;
+
   /* Dig out information for optimizations. */
   r->regstart = '\0';		/* Worst-case defaults. */
   r->reganch = 0;
@@ -1124,6 +1128,499 @@ static char *regnext(char *p)
     return (p + offset);
 }
 
+/*
+ * Linear time matching
+ *
+ * pike_regmatch() answers the same question as pike_regexec(), ie
+ * whether the regexp matches anywhere in the string, but runs the
+ * program as a Thompson NFA instead of backtracking. Every position
+ * in the program that can be active at the same time is kept in a
+ * set, and the sets are cached as the states of a DFA that is built
+ * lazily while the input is scanned. Each character thus costs one
+ * table lookup once the DFA has warmed up, and at most one pass over
+ * the program when a new transition has to be computed.
+ *
+ * A position ("id") in the program is the offset of a node, with two
+ * additions: the offset of the k:th (k > 0) character in the operand
+ * of an EXACTLY node stands for having matched the k first characters
+ * of it, and the offset of a KPLUS node plus one stands for having
+ * matched its operand at least once.
+ *
+ * The assertions \< and \> and $ need to know the next character. If
+ * it isn't known yet they are kept in the set and resolved when the
+ * next character, or the end of the string, is seen. The flags of a
+ * state hold the rest of the context they and ^ need.
+ */
+
+#define DFA_MAX_STATES	256	/* Flush the cache when it has this many. */
+#define DFA_HASH_SIZE	64
+#define DFA_WIDE	256	/* Transition for all characters > 255. */
+
+/* State flags. */
+#define DFA_BOL		1	/* At the beginning of the string. */
+#define DFA_PREVWORD	2	/* The previous character was a word part. */
+#define DFA_MATCH	4	/* END has been reached. */
+
+/* What the closure knows about the next character. Kept apart from
+ * the character itself, since wide strings may contain any INT32.
+ */
+#define DFA_CHAR	0	/* The next character is c. */
+#define DFA_UNKNOWN	1	/* The next character isn't known yet. */
+#define DFA_EOS		2	/* At the end of the string. */
+
+/* Kinds of ids. */
+#define ID_NONE		0
+#define ID_NODE		1	/* The start of a node. */
+#define ID_EXACT	2	/* Inside the operand of an EXACTLY node. */
+#define ID_PLUS		3	/* A KPLUS node that has matched once. */
+
+#define ISWORDCHAR(c)	((c) >= 0 && (c) < 256 && ISWORDPART(c))
+
+struct dfa_state
+{
+  struct dfa_state *next[DFA_WIDE + 1];	/* NULL if not computed yet. */
+  struct dfa_state *hash_next;
+  unsigned INT32 hval;
+  int flags;
+  int eos;			/* Match at the end of string? -1 if unknown. */
+  int n;
+  int ids[1];
+};
+
+struct regdfa
+{
+  struct dfa_state *hash[DFA_HASH_SIZE];
+  struct dfa_state *start;
+  int nstates;
+  int nids;
+  unsigned char *kind;		/* Kind of each id. */
+  int *owner;			/* Node of ID_EXACT and ID_PLUS ids. */
+  unsigned INT32 *mark;		/* Visited in closure number gen. */
+  unsigned INT32 gen;
+  int *stack;
+  int *list;
+};
+
+/* Used as the target of transitions that lead to a match. */
+static struct dfa_state dfa_matched = { { NULL }, NULL, 0, DFA_MATCH, 1, 0, { 0 } };
+
+static struct regdfa *dfa_init(regexp *r)
+{
+  struct regdfa *d;
+  char *s = r->program;
+  int nids = (int)r->regplen;
+
+  /* The list holds the consuming ids of one closure followed by
+   * those of the next, and thus needs room for twice as many.
+   */
+  d = xcalloc(1, sizeof(struct regdfa) + nids * (1 + 5 * sizeof(int)));
+  d->nids = nids;
+  d->owner = (int *)(d + 1);
+  d->mark = (unsigned INT32 *)(d->owner + nids);
+  d->stack = (int *)(d->mark + nids);
+  d->list = d->stack + nids;
+  d->kind = (unsigned char *)(d->list + 2 * nids);
+
+  /* The nodes are laid out one after the other, END being the last. */
+  while (s - r->program < nids)
+  {
+    char op = OP(s);
+    int id = (int)(s - r->program);
+
+    d->kind[id] = ID_NODE;
+    if (op == KPLUS) {
+      d->kind[id + 1] = ID_PLUS;
+      d->owner[id + 1] = id;
+    }
+    s += 3;
+    if (op == ANYOF || op == ANYBUT || op == EXACTLY) {
+      int k;
+      for (k = 0; s[k]; k++)
+        if (op == EXACTLY && k) {
+          d->kind[s - r->program + k] = ID_EXACT;
+          d->owner[s - r->program + k] = id;
+        }
+      s += k + 1;
+    }
+    if (op == END) break;
+  }
+
+  r->dfa = d;
+  return d;
+}
+
+static void dfa_flush(struct regdfa *d)
+{
+  int i;
+  for (i = 0; i < DFA_HASH_SIZE; i++)
+    while (d->hash[i]) {
+      struct dfa_state *s = d->hash[i];
+      d->hash[i] = s->hash_next;
+      free(s);
+    }
+  d->start = NULL;
+  d->nstates = 0;
+}
+
+/*
+ * Start a new closure, forgetting what has been visited.
+ */
+static void dfa_newgen(struct regdfa *d)
+{
+  if (!++d->gen) {
+    memset(d->mark, 0, d->nids * sizeof(unsigned INT32));
+    d->gen = 1;
+  }
+}
+
+/*
+ * Push a node to the closure stack, unless it's been visited already.
+ */
+static inline void dfa_push(struct regdfa *d, int *sp, int id)
+{
+  if (d->mark[id] != d->gen) {
+    d->mark[id] = d->gen;
+    d->stack[(*sp)++] = id;
+  }
+}
+
+#define DFA_PUSH(P) do {				\
+    char *p_ = (P);					\
+    if (p_) dfa_push(d, &sp, (int)(p_ - prog));	\
+  } while (0)
+
+/*
+ * Follow the nodes on the closure stack to all positions that
+ * consume a character, or that wait for the next one to be known,
+ * and append those to d->list. next is one of DFA_CHAR, DFA_UNKNOWN
+ * and DFA_EOS; c is only used for DFA_CHAR. Returns 1 if END was
+ * reached.
+ */
+static int dfa_closure(struct regdfa *d, char *prog, int sp,
+                       int ctx, int next, INT32 c, int *n)
+{
+  int matched = 0;
+
+  while (sp)
+  {
+    int id = d->stack[--sp];
+    char *p = prog + id;
+
+    if (d->kind[id] == ID_EXACT) {
+      d->list[(*n)++] = id;
+      continue;
+    }
+    if (d->kind[id] == ID_PLUS) {
+      d->list[(*n)++] = id;
+      DFA_PUSH(regnext(prog + d->owner[id]));
+      continue;
+    }
+
+    switch (OP(p))
+    {
+    case END:
+      matched = 1;
+      break;
+
+    case BOL:
+      if (ctx & DFA_BOL)
+        DFA_PUSH(regnext(p));
+      break;
+
+    case EOL:
+      if (next == DFA_UNKNOWN)
+        d->list[(*n)++] = id;
+      else if (next == DFA_EOS)
+        DFA_PUSH(regnext(p));
+      break;
+
+    case WORDSTART:
+      if (ctx & DFA_BOL)
+        DFA_PUSH(regnext(p));
+      else if (next == DFA_UNKNOWN)
+        d->list[(*n)++] = id;
+      else if (next == DFA_CHAR && !(ctx & DFA_PREVWORD) && ISWORDCHAR(c))
+        DFA_PUSH(regnext(p));
+      break;
+
+    case WORDEND:
+      if (next == DFA_UNKNOWN)
+        d->list[(*n)++] = id;
+      else if (next == DFA_EOS ||
+               (!(ctx & DFA_BOL) && (ctx & DFA_PREVWORD) && !ISWORDCHAR(c)))
+        DFA_PUSH(regnext(p));
+      break;
+
+    case BRANCH:
+      if (OP(regnext(p)) != BRANCH)
+        DFA_PUSH(OPERAND(p));
+      else {
+        char *scan;
+        for (scan = p; scan != NULL && OP(scan) == BRANCH;
+             scan = regnext(scan))
+          DFA_PUSH(OPERAND(scan));
+      }
+      break;
+
+    case STAR:
+      d->list[(*n)++] = id;
+      DFA_PUSH(regnext(p));
+      break;
+
+    case KPLUS:
+    case EXACTLY:
+    case ANY:
+    case ANYOF:
+    case ANYBUT:
+      d->list[(*n)++] = id;
+      break;
+
+    default:			/* NOTHING, BACK, OPEN and CLOSE. */
+      DFA_PUSH(regnext(p));
+      break;
+    }
+  }
+
+  return matched;
+}
+
+/*
+ * Does the simple node (operand of STAR or KPLUS) match c?
+ */
+static int dfa_simple(const char *node, INT32 c)
+{
+  int in;
+
+  switch (OP(node))
+  {
+  case ANY:
+    return 1;
+  case EXACTLY:
+    return c == UCHARAT(OPERAND(node));
+  case ANYOF:
+  case ANYBUT:
+    in = c > 0 && c < 256 && strchr(OPERAND(node), (int)c) != NULL;
+    return (OP(node) == ANYOF) ? in : !in;
+  }
+  return 0;
+}
+
+static struct dfa_state *dfa_intern(struct regdfa *d, int flags, int n,
+                                    int *flushed)
+{
+  struct dfa_state *s;
+  unsigned INT32 h = flags;
+  int i, j;
+
+  /* Sort the ids, so that equal sets compare equal. */
+  for (i = 1; i < n; i++) {
+    int id = d->list[i];
+    for (j = i; j > 0 && d->list[j - 1] > id; j--)
+      d->list[j] = d->list[j - 1];
+    d->list[j] = id;
+  }
+  for (i = 0; i < n; i++)
+    h = h * 31 + d->list[i];
+
+  for (s = d->hash[h % DFA_HASH_SIZE]; s; s = s->hash_next)
+    if (s->hval == h && s->flags == flags && s->n == n &&
+        !memcmp(s->ids, d->list, n * sizeof(int)))
+      return s;
+
+  if (d->nstates >= DFA_MAX_STATES) {
+    dfa_flush(d);
+    *flushed = 1;
+  }
+
+  s = xcalloc(1, sizeof(struct dfa_state) + n * sizeof(int));
+  s->hval = h;
+  s->flags = flags;
+  s->eos = -1;
+  s->n = n;
+  memcpy(s->ids, d->list, n * sizeof(int));
+  s->hash_next = d->hash[h % DFA_HASH_SIZE];
+  d->hash[h % DFA_HASH_SIZE] = s;
+  d->nstates++;
+  return s;
+}
+
+static struct dfa_state *dfa_start(struct regdfa *d, regexp *r)
+{
+  char *prog = r->program;
+  int sp = 0, n = 0, flushed = 0;
+
+  dfa_newgen(d);
+  DFA_PUSH(prog);
+  if (dfa_closure(d, prog, sp, DFA_BOL, DFA_UNKNOWN, 0, &n))
+    return &dfa_matched;
+  return d->start = dfa_intern(d, DFA_BOL, n, &flushed);
+}
+
+/*
+ * Compute the transition from s on the character c.
+ */
+static struct dfa_state *dfa_step(struct regdfa *d, regexp *r,
+                                  struct dfa_state *s, INT32 c)
+{
+  char *prog = r->program;
+  struct dfa_state *res;
+  int sp = 0, n = 0, i, cnt, flushed = 0;
+  int ctx = (ISWORDCHAR(c) ? DFA_PREVWORD : 0);
+
+  /* Resolve the assertions that were waiting for c. */
+  dfa_newgen(d);
+  for (i = 0; i < s->n; i++)
+    dfa_push(d, &sp, s->ids[i]);
+  if (dfa_closure(d, prog, sp, s->flags, DFA_CHAR, c, &n)) {
+    res = &dfa_matched;
+    goto done;
+  }
+
+  /* Consume c. The list is reused for the next closure, which only
+   * appends past cnt.
+   */
+  cnt = n;
+  sp = 0;
+  dfa_newgen(d);
+  for (i = 0; i < cnt; i++)
+  {
+    int id = d->list[i];
+    char *p;
+
+    switch (d->kind[id])
+    {
+    case ID_EXACT:
+      p = prog + d->owner[id];
+      if (c == UCHARAT(prog + id)) {
+        if (prog[id + 1])
+          dfa_push(d, &sp, id + 1);
+        else
+          DFA_PUSH(regnext(p));
+      }
+      break;
+
+    case ID_PLUS:
+      if (dfa_simple(OPERAND(prog + d->owner[id]), c))
+        dfa_push(d, &sp, id);
+      break;
+
+    default:
+      p = prog + id;
+      switch (OP(p))
+      {
+      case EXACTLY:
+        if (c == UCHARAT(OPERAND(p))) {
+          if (OPERAND(p)[1])
+            DFA_PUSH(OPERAND(p) + 1);
+          else
+            DFA_PUSH(regnext(p));
+        }
+        break;
+      case ANY:
+      case ANYOF:
+      case ANYBUT:
+        if (dfa_simple(p, c))
+          DFA_PUSH(regnext(p));
+        break;
+      case STAR:
+        if (dfa_simple(OPERAND(p), c))
+          dfa_push(d, &sp, id);
+        break;
+      case KPLUS:
+        if (dfa_simple(OPERAND(p), c))
+          dfa_push(d, &sp, id + 1);
+        break;
+      }
+      break;
+    }
+  }
+
+  /* An unanchored match may start at any position. */
+  if (!r->reganch)
+    DFA_PUSH(prog);
+
+  n = cnt;
+  if (dfa_closure(d, prog, sp, ctx, DFA_UNKNOWN, 0, &n)) {
+    res = &dfa_matched;
+    goto done;
+  }
+  memmove(d->list, d->list + cnt, (n - cnt) * sizeof(int));
+  res = dfa_intern(d, ctx, n - cnt, &flushed);
+
+ done:
+  if (!flushed)
+    s->next[(c >= 0 && c < 256) ? c : DFA_WIDE] = res;
+  return res;
+}
+
+/*
+ * Does the string end in a match when in state s?
+ */
+static int dfa_eos(struct regdfa *d, regexp *r, struct dfa_state *s)
+{
+  if (s->eos < 0) {
+    char *prog = r->program;
+    int sp = 0, n = 0, i;
+
+    dfa_newgen(d);
+    for (i = 0; i < s->n; i++)
+      dfa_push(d, &sp, s->ids[i]);
+    s->eos = dfa_closure(d, prog, sp, s->flags, DFA_EOS, 0, &n);
+  }
+  return s->eos;
+}
+
+/*
+ - regmatch - match a regexp against a string in linear time
+ *
+ * Unlike pike_regexec() the string may be wide and contain NUL.
+ */
+int pike_regmatch(regexp *r, PCHARP str, ptrdiff_t len)
+{
+  struct regdfa *d;
+  struct dfa_state *s;
+  ptrdiff_t i;
+
+  if (r == NULL) {
+    regerror("NULL parameter");
+    return 0;
+  }
+
+  d = r->dfa;
+  if (!d) d = dfa_init(r);
+  s = d->start;
+  if (!s) s = dfa_start(d, r);
+
+  for (i = 0; i < len; i++)
+  {
+    INT32 c;
+    struct dfa_state *next;
+
+    if (s->flags & DFA_MATCH) return 1;
+    if (!s->n) return 0;	/* Nothing can match any more. */
+
+    c = INDEX_PCHARP(str, i);
+    next = s->next[(c >= 0 && c < 256) ? c : DFA_WIDE];
+    if (!next) next = dfa_step(d, r, s, c);
+    s = next;
+  }
+
+  if (s->flags & DFA_MATCH) return 1;
+  return dfa_eos(d, r, s);
+}
+
+/*
+ - regfree - free a compiled regexp
+ */
+void pike_regfree(regexp *r)
+{
+  if (r->dfa) {
+    dfa_flush(r->dfa);
+    free(r->dfa);
+  }
+  free(r);
+}
+
 #ifdef PIKE_DEBUG
 
 static char *regprop(char *);
@@ -15,6 +15,7 @@
  */
 
 #define NSUBEXP  40
+struct regdfa;
 typedef struct regexp
 {
   char *startp[NSUBEXP];
@@ -23,6 +24,8 @@ typedef struct regexp
   char reganch;			/* Internal use only. */
   char *regmust;		/* Internal use only. */
   size_t regmlen;		/* Internal use only. */
+  size_t regplen;		/* Internal use only. */
+  struct regdfa *dfa;		/* Internal use only. */
   char program[1];		/* Unwarranted chumminess with compiler. */
 } regexp;
 
@@ -31,6 +34,8 @@ typedef struct regexp
 /* Prototypes begin here */
 regexp *pike_regcomp(const char *exp);
 int pike_regexec(regexp *prog, char *string);
+int pike_regmatch(regexp *r, PCHARP str, ptrdiff_t len);
+void pike_regfree(regexp *r);
 /* Prototypes end here */
 
 #endif
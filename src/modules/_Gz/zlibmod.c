@@ -21,6 +21,7 @@
 #include "buffer.h"
 #include "operators.h"
 #include "bignum.h"
+#include "modules/_Stdio/buffer.h"
 
 #include <zlib.h>
 
@@ -865,11 +866,18 @@ static void gz_inflate_create(INT32 args)
   }
 }
 
+/* Inflates into buf, or if out isn't NULL, into out using buf as
+ * scratch space. The output space is grown from BUF to MAX_BUF as
+ * long as it's filled, so that large inflates release the interpreter
+ * lock fewer times.
+ */
 static int do_inflate(struct byte_buffer *buf,
 		      struct zipper *this,
-		      int flush)
+		      int flush,
+		      Buffer *out)
 {
   int fail=0;
+  size_t chunk=BUF;
 
 #ifdef _REENTRANT
   ONERROR uwp;
@@ -892,15 +900,24 @@ static int do_inflate(struct byte_buffer *buf,
     {
       char *loc;
       int ret;
-      loc=buffer_alloc(buf, BUF);
+      loc=buffer_alloc(buf, chunk);
       THREADS_ALLOW();
       this->gz.next_out=(Bytef *)loc;
-      this->gz.avail_out=BUF;
+      this->gz.avail_out=(unsigned INT32)chunk;
 
       ret=inflate(& this->gz, flush);
 
       THREADS_DISALLOW();
-      buffer_remove(buf, this->gz.avail_out);
+      if (out) {
+	size_t len = chunk - this->gz.avail_out;
+	memcpy(io_add_space(out, len, 0), loc, len);
+	out->len += len;
+	buffer_remove(buf, chunk);
+      } else
+	buffer_remove(buf, this->gz.avail_out);
+
+      if (!this->gz.avail_out && chunk < MAX_BUF)
+	chunk *= 2;
 
       if(ret == Z_BUF_ERROR) ret=Z_OK;
 
@@ -966,7 +983,7 @@ void low_zlibmod_unpack(struct memobj data, struct byte_buffer *buf, int raw)
   }
 
   mt_init(&z.lock);
-  ret = do_inflate(buf, &z, Z_SYNC_FLUSH);
+  ret = do_inflate(buf, &z, Z_SYNC_FLUSH, NULL);
   mt_destroy(&z.lock);
   inflateEnd( &z.gz );
 
@@ -1064,6 +1081,13 @@ static void gz_uncompress(INT32 args)
  *!   write(inflate(s));
  *! @endcode
  *!
+ *! @decl int inflate(string(8bit)|String.Buffer|System.Memory|Stdio.Buffer data, @
+ *!                 Stdio.Buffer out)
+ *!
+ *! If @[out] is given, the decompressed data is appended to it
+ *! directly instead of being returned as a string, and the number
+ *! of bytes appended is returned.
+ *!
  *! @seealso
  *! @[Gz.deflate->deflate()], @[Gz.uncompress]
  */
@@ -1073,6 +1097,8 @@ static void gz_inflate(INT32 args)
   int fail;
   struct zipper *this=THIS;
   struct byte_buffer buf;
+  Buffer *out = NULL;
+  size_t out_len = 0;
   ONERROR err;
 
   if(!THIS->gz.state)
@@ -1110,13 +1136,20 @@ static void gz_inflate(INT32 args)
   if (data.len > (size_t)(unsigned INT32)~0u)
     Pike_error("Input too large for gz_inflate->inflate().\n");
 
+  if (args > 1) {
+    if (TYPEOF(Pike_sp[1-args]) != PIKE_T_OBJECT ||
+	!(out = io_buffer_from_object(Pike_sp[1-args].u.object)))
+      SIMPLE_ARG_TYPE_ERROR("inflate", 2, "Stdio.Buffer");
+    out_len = io_len(out);
+  }
+
   this->gz.next_in=(Bytef *)data.ptr;
   this->gz.avail_in = (unsigned INT32)(data.len);
 
   buffer_init(&buf);
 
   SET_ONERROR(err,buffer_free,&buf);
-  fail=do_inflate(&buf,this,Z_SYNC_FLUSH);
+  fail=do_inflate(&buf,this,Z_SYNC_FLUSH,out);
   UNSET_ONERROR(err);
 
   if(fail != Z_OK && fail != Z_STREAM_END)
@@ -1128,9 +1161,16 @@ static void gz_inflate(INT32 args)
       Pike_error("Error in gz_inflate->inflate(): %d\n",fail);
   }
 
-  pop_n_elems(args);
-
-  push_string(buffer_finish_pike_string(&buf));
+  if (out) {
+    buffer_free(&buf);
+    io_trigger_output(out);
+    out_len = io_len(out) - out_len;
+    pop_n_elems(args);
+    push_int64(out_len);
+  } else {
+    pop_n_elems(args);
+    push_string(buffer_finish_pike_string(&buf));
+  }
 
   if(fail == Z_STREAM_END)
   {
@@ -1206,9 +1246,16 @@ static void gz_crc32(INT32 args)
    } else
       crc=0;
 
-   crc=crc32(crc,
-	     (unsigned char*)sp[-args].u.string->str,
-             (unsigned INT32)(sp[-args].u.string->len));
+   if (sp[-args].u.string->len > BUF) {
+     unsigned char *str = (unsigned char*)sp[-args].u.string->str;
+     unsigned INT32 len = (unsigned INT32)(sp[-args].u.string->len);
+     THREADS_ALLOW();
+     crc=crc32(crc, str, len);
+     THREADS_DISALLOW();
+   } else
+     crc=crc32(crc,
+	       (unsigned char*)sp[-args].u.string->str,
+	       (unsigned INT32)(sp[-args].u.string->len));
 
    pop_n_elems(args);
    push_int64((INT64)crc);
@@ -1234,9 +1281,16 @@ static void gz_adler32(INT32 args)
    } else
       crc=1;
 
-   crc=adler32(crc,
-               (unsigned char*)sp[-args].u.string->str,
-               (unsigned INT32)(sp[-args].u.string->len));
+   if (sp[-args].u.string->len > BUF) {
+     unsigned char *str = (unsigned char*)sp[-args].u.string->str;
+     unsigned INT32 len = (unsigned INT32)(sp[-args].u.string->len);
+     THREADS_ALLOW();
+     crc=adler32(crc, str, len);
+     THREADS_DISALLOW();
+   } else
+     crc=adler32(crc,
+		 (unsigned char*)sp[-args].u.string->str,
+		 (unsigned INT32)(sp[-args].u.string->len));
 
    pop_n_elems(args);
    push_int64((INT64)crc);
@@ -1377,7 +1431,9 @@ PIKE_MODULE_INIT
   /* function(int|void:void) */
   ADD_FUNCTION("create",gz_inflate_create,tFunc(tOr(tMapping,tOr(tInt,tVoid)),tVoid),0);
   /* function(string(8bit)|String.Buffer|System.Memory|Stdio.Buffer:string(8bit)) */
-  ADD_FUNCTION("inflate",gz_inflate,tFunc(tOr(tStr8,tObj),tStr8),0);
+  ADD_FUNCTION("inflate",gz_inflate,
+	       tOr(tFunc(tOr(tStr8,tObj),tStr8),
+		   tFunc(tOr(tStr8,tObj) tObj,tInt)),0);
   /* function(:string(8bit)) */
   ADD_FUNCTION("end_of_stream",gz_end_of_stream,tFunc(tNone,tStr8),0);
   ADD_FUNCTION("_size_object", gz_inflate_size, tFunc(tVoid,tInt), 0);
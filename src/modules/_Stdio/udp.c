@@ -75,6 +75,10 @@
 #include <netinet/in.h>
 #endif
 
+#ifdef HAVE_NETINET_UDP_H
+#include <netinet/udp.h>
+#endif
+
 #ifdef HAVE_ARPA_INET_H
 #ifndef ARPA_INET_H
 #include <arpa/inet.h>
@@ -124,12 +128,20 @@ struct udp_storage {
 
   struct svalue read_callback;	/* Mapped. */
   struct svalue write_callback;	/* Mapped. */
+
+  /* Receive buffer kept between calls to read_many(). */
+  char *read_buf;
+  size_t read_buf_size;
 };
 
 void zero_udp(struct object *ignored);
 int low_exit_udp(void);
 void exit_udp(struct object *UNUSED(ignored)) {
   low_exit_udp();
+  if (THIS->read_buf) {
+    free(THIS->read_buf);
+    THIS->read_buf = NULL;
+  }
 }
 
 #undef THIS
@@ -875,6 +887,93 @@ void udp_wait(INT32 args)
 
 #define UDP_BUFFSIZE 65536
 
+/* Push the address part of a received sockaddr as a string. */
+static void push_udp_address(PIKE_SOCKADDR *from)
+{
+#ifdef fd_inet_ntop
+  char buffer[64];	/* Larger than INET6_ADDRSTRLEN. */
+  if (!fd_inet_ntop( SOCKADDR_FAMILY(*from), SOCKADDR_IN_ADDR(*from),
+		     buffer, sizeof(buffer) )) {
+    push_static_text("UNSUPPORTED");
+  } else {
+    /* NOTE: IPv6-mapped IPv4 addresses may only
+     *       connect to other IPv4 addresses.
+     *
+     * Make the Pike-level code believe it has an actual IPv4 address
+     * when getting a mapped address (::FFFF:a.b.c.d).
+     */
+    if ((!strncmp(buffer, "::FFFF:", 7) || !strncmp(buffer, "::ffff:", 7)) &&
+	!strchr(buffer + 7, ':')) {
+      push_text(buffer+7);
+    } else {
+      push_text(buffer);
+    }
+  }
+#else
+  push_text( inet_ntoa( *SOCKADDR_IN_ADDR(*from) ) );
+#endif
+}
+
+/* Convert the flag argument of read() and read_many() to recv flags. */
+static int udp_read_flags(INT_TYPE flag)
+{
+  int flags = 0;
+  if(flag & 1) {
+    flags |= MSG_OOB;
+  }
+  if(flag & 2) {
+#ifdef MSG_PEEK
+    flags |= MSG_PEEK;
+#else /* !MSG_PEEK */
+    /* FIXME: What should we do here? */
+#endif /* MSG_PEEK */
+  }
+  if(flag & ~3) {
+    Pike_error("Illegal flags argument.\n");
+  }
+  return flags;
+}
+
+/* Throw an error for a failed receive, unless the error just
+ * means that there was nothing to read.
+ */
+static void udp_read_error(int e, int flags)
+{
+  switch(e)
+  {
+     case EBADF:
+	if (THIS->box.backend)
+	  set_fd_callback_events (&THIS->box, 0, 0);
+	Pike_error("Socket closed\n");
+#ifdef ESTALE
+     case ESTALE:
+#endif
+     case EIO:
+	if (THIS->box.backend)
+	  set_fd_callback_events (&THIS->box, 0, 0);
+	Pike_error("I/O error\n");
+     case ENOMEM:
+#ifdef ENOSR
+     case ENOSR:
+#endif /* ENOSR */
+	Pike_error("Out of memory\n");
+#ifdef ENOTSOCK
+     case ENOTSOCK:
+	Pike_fatal("reading from non-socket fd!!!\n");
+#endif
+     case EINVAL:
+       if (!(flags & MSG_OOB)) {
+	 Pike_error("Socket read failed with EINVAL.\n");
+       }
+       /* FALLTHRU */
+     case EWOULDBLOCK:
+	return;
+
+     default:
+	Pike_error("Socket read failed with errno %d.\n", e);
+  }
+}
+
 /*! @decl mapping(string:int|string) read()
  *! @decl mapping(string:int|string) read(int flag)
  *!
@@ -901,21 +1000,7 @@ void udp_read(INT32 args)
   ACCEPT_SIZE_T fromlen = sizeof(from);
 
   if(args)
-  {
-    if(Pike_sp[-args].u.integer & 1) {
-      flags |= MSG_OOB;
-    }
-    if(Pike_sp[-args].u.integer & 2) {
-#ifdef MSG_PEEK
-      flags |= MSG_PEEK;
-#else /* !MSG_PEEK */
-      /* FIXME: What should we do here? */
-#endif /* MSG_PEEK */
-    }
-    if(Pike_sp[-args].u.integer & ~3) {
-      Pike_error("Illegal flags argument.\n");
-    }
-  }
+    flags = udp_read_flags(Pike_sp[-args].u.integer);
   pop_n_elems(args);
   fd = FD;
   if (FD < 0)
@@ -934,40 +1019,9 @@ void udp_read(INT32 args)
 
   if(res<0)
   {
-    switch(e)
-    {
-       case EBADF:
-	  if (THIS->box.backend)
-	    set_fd_callback_events (&THIS->box, 0, 0);
-	  Pike_error("Socket closed\n");
-#ifdef ESTALE
-       case ESTALE:
-#endif
-       case EIO:
-	  if (THIS->box.backend)
-	    set_fd_callback_events (&THIS->box, 0, 0);
-	  Pike_error("I/O error\n");
-       case ENOMEM:
-#ifdef ENOSR
-       case ENOSR:
-#endif /* ENOSR */
-	  Pike_error("Out of memory\n");
-#ifdef ENOTSOCK
-       case ENOTSOCK:
-	  Pike_fatal("reading from non-socket fd!!!\n");
-#endif
-       case EINVAL:
-	 if (!(flags & MSG_OOB)) {
-	   Pike_error("Socket read failed with EINVAL.\n");
-	 }
-	 /* FALLTHRU */
-       case EWOULDBLOCK:
-	  push_int( 0 );
-	  return;
-
-       default:
-	  Pike_error("Socket read failed with errno %d.\n", e);
-    }
+    udp_read_error(e, flags);
+    push_int( 0 );
+    return;
   }
   /* Now comes the interresting part.
    * make a nice mapping from this stuff..
@@ -976,27 +1030,7 @@ void udp_read(INT32 args)
   push_string( make_shared_binary_string(buffer, res) );
 
   push_static_text("ip");
-#ifdef fd_inet_ntop
-  if (!fd_inet_ntop( SOCKADDR_FAMILY(from), SOCKADDR_IN_ADDR(from),
-		     buffer, sizeof(buffer) )) {
-    push_static_text("UNSUPPORTED");
-  } else {
-    /* NOTE: IPv6-mapped IPv4 addresses may only
-     *       connect to other IPv4 addresses.
-     *
-     * Make the Pike-level code believe it has an actual IPv4 address
-     * when getting a mapped address (::FFFF:a.b.c.d).
-     */
-    if ((!strncmp(buffer, "::FFFF:", 7) || !strncmp(buffer, "::ffff:", 7)) &&
-	!strchr(buffer + 7, ':')) {
-      push_text(buffer+7);
-    } else {
-      push_text(buffer);
-    }
-  }
-#else
-  push_text( inet_ntoa( *SOCKADDR_IN_ADDR(from) ) );
-#endif
+  push_udp_address(&from);
 
   push_constant_text("port");
   push_int(ntohs(from.ipv4.sin_port));
@@ -1145,6 +1179,569 @@ void udp_sendto(INT32 args)
 }
 
 
+/* Maximum number of datagrams handled by a single batch system call. */
+#define UDP_MAX_BATCH	1024
+
+/* Maximum size of the receive buffer for a batch. */
+#define UDP_MAX_BATCH_BYTES	(1024 * 1024)
+
+#ifdef MSG_DONTWAIT
+#define UDP_DONTWAIT	MSG_DONTWAIT
+#else
+#define UDP_DONTWAIT	0
+#endif
+
+#if defined(__linux__) && defined(IPPROTO_UDP)
+/* Generic segmentation/receive offload; may be missing from older
+ * libc headers even though the running kernel supports them.
+ */
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT	103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO		104
+#endif
+#endif /* __linux__ && IPPROTO_UDP */
+
+#if defined(HAVE_RECVMMSG) && !defined(MSG_WAITFORONE)
+/* We must not block waiting for more than one datagram. */
+#undef HAVE_RECVMMSG
+#endif
+
+struct udp_dgram
+{
+  PIKE_SOCKADDR from;
+  size_t len;
+  int segment;		/* GRO segment size, or 0. */
+};
+
+struct udp_batch
+{
+  char *buffer;
+  struct udp_dgram *dgrams;
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr *msgs;
+  struct iovec *iov;
+  char *control;
+#endif
+};
+
+#ifdef HAVE_RECVMMSG
+#ifdef UDP_GRO
+#define UDP_CONTROL_SIZE	CMSG_SPACE(sizeof(int))
+#else
+#define UDP_CONTROL_SIZE	0
+#endif
+#endif
+
+/* Keep the receive buffer of the batch for the next read_many(). */
+static void keep_udp_batch_buffer(struct udp_batch *b, size_t size)
+{
+  struct udp_storage *udp = THIS;
+
+  /* The object may have been destructed while the lock was released. */
+  if (!THISOBJ->prog || (size > UDP_MAX_BATCH_BYTES)) return;
+  if (udp->read_buf) {
+    if (udp->read_buf_size >= size) return;
+    free(udp->read_buf);
+  }
+  udp->read_buf = b->buffer;
+  udp->read_buf_size = size;
+  b->buffer = NULL;
+}
+
+static void free_udp_batch(struct udp_batch *b)
+{
+  if (b->buffer) free(b->buffer);
+  if (b->dgrams) free(b->dgrams);
+#ifdef HAVE_RECVMMSG
+  if (b->msgs) free(b->msgs);
+  if (b->iov) free(b->iov);
+  if (b->control) free(b->control);
+#endif
+}
+
+/*! @decl array(array(string(8bit))|array(int)) read_many(int(1..) max, @
+ *!                                                       int|void flag, @
+ *!                                                       int(1..)|void max_size)
+ *!
+ *! Read up to @[max] datagrams from the UDP socket.
+ *!
+ *! This is equivalent to calling @[read()] repeatedly, but uses a
+ *! single system call (@tt{recvmmsg(2)@}) where available, and
+ *! returns the result in a compact form that doesn't need a mapping
+ *! per datagram.
+ *!
+ *! Blocks until at least one datagram is available if the socket is
+ *! in blocking mode, but never waits for more than one.
+ *!
+ *! @param max
+ *!   Maximum number of datagrams to read. At most 1024 datagrams,
+ *!   and no more than fit in one megabyte of @[max_size] buffers
+ *!   (but at least one), are read per call.
+ *!
+ *! @param flag
+ *!   Same as for @[read()]. Peeking limits @[max] to @expr{1@}.
+ *!
+ *! @param max_size
+ *!   Maximum size of a single received datagram; longer datagrams are
+ *!   truncated. Defaults to @expr{65536@}. Note that with @[enable_gro()]
+ *!   a single receive may contain several coalesced datagrams.
+ *!
+ *! @returns
+ *!   Returns @expr{0@} (zero) if no datagram was available on a
+ *!   nonblocking socket. Otherwise returns an array of three arrays
+ *!   of the same size, with one element per datagram:
+ *!   @array
+ *!     @elem array(string(8bit)) 0
+ *!       The received data.
+ *!     @elem array(string) 1
+ *!       The address the data was received from.
+ *!     @elem array(int) 2
+ *!       The port the data was received from.
+ *!   @endarray
+ *!
+ *!   Datagrams coalesced by the kernel due to @[enable_gro()] are
+ *!   split up again, so every element corresponds to one datagram
+ *!   as sent by the peer.
+ *!
+ *! @seealso
+ *!   @[read()], @[send_many()], @[enable_gro()]
+ */
+static void udp_read_many(INT32 args)
+{
+  INT_TYPE max, flag = 0, max_size = UDP_BUFFSIZE;
+  int flags, fd, e = 0, cnt = 0, nb, i, j, total;
+  struct udp_batch b;
+  struct array *data, *ips, *ports;
+  ONERROR err;
+
+  get_all_args("read_many", args, "%+.%i%+", &max, &flag, &max_size);
+  flags = udp_read_flags(flag);
+  if (!max)
+    SIMPLE_ARG_TYPE_ERROR("read_many", 1, "int(1..)");
+  if (!max_size)
+    SIMPLE_ARG_TYPE_ERROR("read_many", 3, "int(1..)");
+  if (max > UDP_MAX_BATCH) max = UDP_MAX_BATCH;
+  if (max > UDP_MAX_BATCH_BYTES / max_size) {
+    max = UDP_MAX_BATCH_BYTES / max_size;
+    if (!max) max = 1;
+  }
+#ifdef MSG_PEEK
+  if (flags & MSG_PEEK) max = 1;
+#endif
+  if (max_size > 0x7fffffff / max)
+    Pike_error("Too large receive buffer requested.\n");
+
+  fd = FD;
+  if (fd < 0)
+    Pike_error("Not open\n");
+  nb = THIS->inet_flags & PIKE_INET_FLAG_NB;
+
+  memset(&b, 0, sizeof(b));
+  SET_ONERROR(err, free_udp_batch, &b);
+  if (THIS->read_buf && (THIS->read_buf_size >= (size_t)(max * max_size))) {
+    /* Take it, in case another thread calls read_many() meanwhile. */
+    b.buffer = THIS->read_buf;
+    THIS->read_buf = NULL;
+  } else {
+    b.buffer = xalloc(max * max_size);
+  }
+  b.dgrams = xalloc(max * sizeof(struct udp_dgram));
+#ifdef HAVE_RECVMMSG
+  b.msgs = xcalloc(max, sizeof(struct mmsghdr));
+  b.iov = xalloc(max * sizeof(struct iovec));
+  if (UDP_CONTROL_SIZE)
+    b.control = xcalloc(max, UDP_CONTROL_SIZE);
+  for (i = 0; i < max; i++) {
+    b.iov[i].iov_base = b.buffer + i * max_size;
+    b.iov[i].iov_len = max_size;
+    b.msgs[i].msg_hdr.msg_iov = b.iov + i;
+    b.msgs[i].msg_hdr.msg_iovlen = 1;
+    b.msgs[i].msg_hdr.msg_name = &b.dgrams[i].from;
+  }
+#endif
+
+  do {
+#ifdef HAVE_RECVMMSG
+    for (i = 0; i < max; i++) {
+      b.msgs[i].msg_hdr.msg_namelen = sizeof(PIKE_SOCKADDR);
+      if (b.control) {
+	b.msgs[i].msg_hdr.msg_control = b.control + i * UDP_CONTROL_SIZE;
+	b.msgs[i].msg_hdr.msg_controllen = UDP_CONTROL_SIZE;
+      }
+    }
+#endif
+    THREADS_ALLOW();
+#ifdef HAVE_RECVMMSG
+    cnt = recvmmsg(fd, b.msgs, max, flags | (nb ? 0 : MSG_WAITFORONE), NULL);
+    e = errno;
+#else
+    for (cnt = 0; cnt < max; cnt++) {
+      ACCEPT_SIZE_T fromlen = sizeof(PIKE_SOCKADDR);
+      ptrdiff_t res;
+      if (cnt && !UDP_DONTWAIT && !nb) break;
+      res = fd_recvfrom(fd, b.buffer + cnt * max_size, max_size,
+			flags | (cnt ? UDP_DONTWAIT : 0),
+			(struct sockaddr *)&b.dgrams[cnt].from, &fromlen);
+      if (res < 0) {
+	e = errno;
+	break;
+      }
+      b.dgrams[cnt].len = res;
+      b.dgrams[cnt].segment = 0;
+    }
+    if (!cnt) cnt = -1;
+#endif
+    THREADS_DISALLOW();
+
+    check_threads_etc();
+  } while ((cnt < 0) && (e == EINTR));
+
+  THIS->my_errno = errno = (cnt < 0) ? e : 0;
+
+  if (cnt < 0) {
+    udp_read_error(e, flags);
+    keep_udp_batch_buffer(&b, max * max_size);
+    CALL_AND_UNSET_ONERROR(err);
+    pop_n_elems(args);
+    push_int(0);
+    return;
+  }
+
+  /* Count the datagrams, including ones coalesced by GRO. */
+  total = 0;
+  for (i = 0; i < cnt; i++) {
+    struct udp_dgram *d = b.dgrams + i;
+#ifdef HAVE_RECVMMSG
+#ifdef UDP_GRO
+    struct cmsghdr *cmsg;
+#endif
+    d->len = b.msgs[i].msg_len;
+    d->segment = 0;
+#ifdef UDP_GRO
+    for (cmsg = CMSG_FIRSTHDR(&b.msgs[i].msg_hdr); cmsg;
+	 cmsg = CMSG_NXTHDR(&b.msgs[i].msg_hdr, cmsg)) {
+      if ((cmsg->cmsg_level == IPPROTO_UDP) &&
+	  (cmsg->cmsg_type == UDP_GRO)) {
+	memcpy(&d->segment, CMSG_DATA(cmsg), sizeof(int));
+      }
+    }
+#endif
+#endif
+    if ((d->segment > 0) && (d->len > (size_t)d->segment))
+      total += (d->len + d->segment - 1) / d->segment;
+    else
+      total++;
+  }
+
+  data = allocate_array(total);
+  push_array(data);
+  ips = allocate_array(total);
+  push_array(ips);
+  ports = allocate_array(total);
+  push_array(ports);
+
+  for (i = j = 0; i < cnt; i++) {
+    struct udp_dgram *d = b.dgrams + i;
+    char *buf = b.buffer + i * max_size;
+    size_t len = d->len;
+    size_t seg = ((d->segment > 0) && (len > (size_t)d->segment)) ?
+      (size_t)d->segment : len;
+    int port = ntohs(d->from.ipv4.sin_port);
+
+    push_udp_address(&d->from);
+    do {
+      size_t l = (len < seg) ? len : seg;
+      SET_SVAL(ITEM(data)[j], PIKE_T_STRING, 0, string,
+	       make_shared_binary_string(buf, l));
+      assign_svalue_no_free(ITEM(ips) + j, Pike_sp - 1);
+      SET_SVAL(ITEM(ports)[j], PIKE_T_INT, NUMBER_NUMBER, integer, port);
+      buf += l;
+      len -= l;
+      j++;
+    } while (len);
+    pop_stack();
+  }
+  data->type_field = BIT_STRING;
+  ips->type_field = BIT_STRING;
+  ports->type_field = BIT_INT;
+
+  keep_udp_batch_buffer(&b, max * max_size);
+  CALL_AND_UNSET_ONERROR(err);
+
+  f_aggregate(3);
+  stack_pop_n_elems_keep_top(args);
+
+  if (!nb)
+    INVALIDATE_CURRENT_TIME();
+}
+
+/*! @decl int send_many(string|zero to, int|string port, @
+ *!                     array(string(8bit)) messages, int|void flags)
+ *! @decl int send_many(array(string) to, array(int|string) port, @
+ *!                     array(string(8bit)) messages, int|void flags)
+ *!
+ *! Send several datagrams with as few system calls as possible
+ *! (@tt{sendmmsg(2)@} where available).
+ *!
+ *! @param to
+ *! @param port
+ *!   The recipient of all of the @[messages], or arrays with one
+ *!   recipient per message. For @[connect()]ed objects the default
+ *!   recipient is used in the same way as for @[send()].
+ *!
+ *! @param messages
+ *!   The datagrams to send.
+ *!
+ *! @param flags
+ *!   Same as for @[send()].
+ *!
+ *! @returns
+ *!   Returns the number of datagrams that were sent, which may be
+ *!   less than the number of @[messages] if the send buffers got
+ *!   full on a nonblocking socket. Returns @expr{-1@} if no datagram
+ *!   could be sent, in which case @[errno()] contains the cause.
+ *!
+ *! @seealso
+ *!   @[send()], @[read_many()], @[set_segment_size()]
+ */
+static void udp_send_many(INT32 args)
+{
+  struct array *msgs, *to_a = NULL, *port_a = NULL;
+  INT_TYPE flag = 0;
+  int flags = 0, fd, e = 0, i, n, sent = 0;
+  PIKE_SOCKADDR *addrs = NULL;
+  int *addr_lens = NULL;
+  ONERROR err, err2;
+
+  if (FD < 0)
+    Pike_error("UDP: not open\n");
+
+  check_all_args("send_many", args,
+		 BIT_ZERO|BIT_STRING|BIT_ARRAY, BIT_INT|BIT_STRING|BIT_ARRAY,
+		 BIT_ARRAY, BIT_INT|BIT_VOID, 0);
+
+  msgs = Pike_sp[2-args].u.array;
+  n = msgs->size;
+  if (args > 3) flag = Pike_sp[3-args].u.integer;
+  if (flag & 1) flags |= MSG_OOB;
+#ifdef MSG_DONTROUTE
+  if (flag & 2) flags |= MSG_DONTROUTE;
+#endif
+  if (flag & ~3)
+    Pike_error("Illegal flags argument.\n");
+
+  /* Work on a private copy, since the array may be modified
+   * by other threads while the lock is released.
+   */
+  msgs = copy_array(msgs);
+  push_array(msgs);
+
+  for (i = 0; i < n; i++) {
+    if ((TYPEOF(ITEM(msgs)[i]) != PIKE_T_STRING) ||
+	ITEM(msgs)[i].u.string->size_shift)
+      SIMPLE_ARG_TYPE_ERROR("send_many", 3, "array(string(8bit))");
+  }
+
+  if (TYPEOF(Pike_sp[-args]) == PIKE_T_ARRAY) {
+    to_a = Pike_sp[-args].u.array;
+    if ((TYPEOF(Pike_sp[1-args]) != PIKE_T_ARRAY) ||
+	((port_a = Pike_sp[1-args].u.array)->size != n) ||
+	(to_a->size != n))
+      Pike_error("Recipient arrays must have the same size as messages.\n");
+  } else if (TYPEOF(Pike_sp[1-args]) == PIKE_T_ARRAY) {
+    SIMPLE_ARG_TYPE_ERROR("send_many", 2, "int|string");
+  }
+
+  /* Resolve the recipients. */
+  addrs = xalloc((to_a ? n : 1) * sizeof(PIKE_SOCKADDR) + 1);
+  SET_ONERROR(err, free, addrs);
+  addr_lens = xcalloc(to_a ? n : 1, sizeof(int));
+  SET_ONERROR(err2, free, addr_lens);
+  for (i = 0; i < (to_a ? n : 1); i++) {
+    struct svalue *to = to_a ? ITEM(to_a) + i : Pike_sp - args;
+    struct svalue *port = port_a ? ITEM(port_a) + i : Pike_sp + 1 - args;
+    if ((TYPEOF(*to) == PIKE_T_STRING) && to->u.string->len) {
+      if ((TYPEOF(*port) != PIKE_T_INT) && (TYPEOF(*port) != PIKE_T_STRING))
+	SIMPLE_ARG_TYPE_ERROR("send_many", 2, "array(int|string)");
+      addr_lens[i] =
+	get_inet_addr(addrs + i, to->u.string->str,
+		      (TYPEOF(*port) == PIKE_T_STRING? port->u.string->str:NULL),
+		      (TYPEOF(*port) == PIKE_T_INT? port->u.integer : -1),
+		      THIS->inet_flags);
+    } else if (!UNSAFE_IS_ZERO(to) &&
+	       !((TYPEOF(*to) == PIKE_T_STRING) && !to->u.string->len)) {
+      SIMPLE_ARG_TYPE_ERROR("send_many", 1, "array(string)");
+    }
+  }
+
+  INVALIDATE_CURRENT_TIME();
+
+  fd = FD;
+  while (sent < n) {
+    int cnt = 0;
+    int batch = n - sent;
+#ifdef HAVE_SENDMMSG
+    struct mmsghdr hdrs[64];
+    struct iovec iov[64];
+#else
+    char *bufs[64];
+    size_t lens[64];
+    PIKE_SOCKADDR *names[64];
+    int name_lens[64];
+#endif
+    if (batch > 64) batch = 64;
+    /* Pike data may not be touched while the lock is released. */
+#ifdef HAVE_SENDMMSG
+    memset(hdrs, 0, sizeof(hdrs));
+#endif
+    for (i = 0; i < batch; i++) {
+      struct pike_string *str = ITEM(msgs)[sent + i].u.string;
+      int a = to_a ? sent + i : 0;
+#ifdef HAVE_SENDMMSG
+      iov[i].iov_base = str->str;
+      iov[i].iov_len = str->len;
+      hdrs[i].msg_hdr.msg_iov = iov + i;
+      hdrs[i].msg_hdr.msg_iovlen = 1;
+      if (addr_lens[a]) {
+	hdrs[i].msg_hdr.msg_name = addrs + a;
+	hdrs[i].msg_hdr.msg_namelen = addr_lens[a];
+      }
+#else
+      bufs[i] = str->str;
+      lens[i] = str->len;
+      names[i] = addr_lens[a] ? addrs + a : NULL;
+      name_lens[i] = addr_lens[a];
+#endif
+    }
+    THREADS_ALLOW();
+#ifdef HAVE_SENDMMSG
+    cnt = sendmmsg(fd, hdrs, batch, flags);
+    e = errno;
+#else
+    for (cnt = 0; cnt < batch; cnt++) {
+      if (fd_sendto(fd, bufs[cnt], lens[cnt], flags,
+		    (struct sockaddr *)names[cnt], name_lens[cnt]) < 0) {
+	e = errno;
+	break;
+      }
+    }
+    if (!cnt) cnt = -1;
+#endif
+    THREADS_DISALLOW();
+
+    check_threads_etc();
+
+    if (cnt < 0) {
+      if (e == EINTR) continue;
+      break;
+    }
+    if (!cnt) break;
+    sent += cnt;
+  }
+
+  CALL_AND_UNSET_ONERROR(err2);
+  CALL_AND_UNSET_ONERROR(err);
+
+  if (sent < n) {
+    THIS->my_errno = e;
+    switch(e) {
+      case EBADF:
+	if (THIS->box.backend)
+	  set_fd_callback_events (&THIS->box, 0, 0);
+	Pike_error("Socket closed\n");
+      case ENOMEM:
+#ifdef ENOSR
+      case ENOSR:
+#endif /* ENOSR */
+	Pike_error("Out of memory\n");
+#ifdef ENOTSOCK
+      case ENOTSOCK:
+	Pike_error("Not a socket!!!\n");
+#endif
+    }
+  }
+
+  pop_n_elems(args + 1);
+  push_int((n && !sent) ? -1 : sent);
+  if (!(THIS->inet_flags & PIKE_INET_FLAG_NB))
+    INVALIDATE_CURRENT_TIME();
+}
+
+#ifdef UDP_GRO
+/*! @decl int(0..1) enable_gro(int(0..1)|void enable)
+ *!
+ *! Enable (or disable if @[enable] is @expr{0@}) generic receive
+ *! offload (@tt{UDP_GRO@}) on the socket.
+ *!
+ *! With GRO enabled the kernel may coalesce several datagrams from
+ *! the same peer into a single receive, which @[read_many()] then
+ *! splits up again. This reduces the per-datagram overhead at high
+ *! packet rates.
+ *!
+ *! @returns
+ *!   Returns @expr{1@} on success, and @expr{0@} (zero) otherwise
+ *!   (eg if the kernel doesn't support it), in which case
+ *!   @[errno()] contains the cause.
+ *!
+ *! @note
+ *!   @[read()] doesn't split coalesced datagrams, so only use
+ *!   @[read_many()] on sockets with GRO enabled.
+ *!
+ *! @note
+ *!   Only available on Linux.
+ */
+static void udp_enable_gro(INT32 args)
+{
+  INT_TYPE enable = 1;
+  int o;
+  get_all_args("enable_gro", args, ".%i", &enable);
+  if (FD < 0) Pike_error("Not open\n");
+  o = !!enable;
+  o = fd_setsockopt(FD, IPPROTO_UDP, UDP_GRO, (char *)&o, sizeof(int));
+  THIS->my_errno = errno;
+  pop_n_elems(args);
+  push_int(!o);
+}
+#endif /* UDP_GRO */
+
+#ifdef UDP_SEGMENT
+/*! @decl int(0..1) set_segment_size(int(0..65535) size)
+ *!
+ *! Set the generic segmentation offload (@tt{UDP_SEGMENT@}) size
+ *! for the socket.
+ *!
+ *! When set to a nonzero value, messages passed to @[send()] or
+ *! @[send_many()] that are longer than @[size] bytes are split by
+ *! the kernel (or network card) into datagrams of @[size] bytes each
+ *! (the last one may be shorter). This lets a single call send many
+ *! datagrams to the same recipient.
+ *!
+ *! @returns
+ *!   Returns @expr{1@} on success, and @expr{0@} (zero) otherwise,
+ *!   in which case @[errno()] contains the cause.
+ *!
+ *! @note
+ *!   Only available on Linux.
+ */
+static void udp_set_segment_size(INT32 args)
+{
+  INT_TYPE size;
+  int o;
+  get_all_args("set_segment_size", args, "%+", &size);
+  if (size > 65535)
+    SIMPLE_ARG_TYPE_ERROR("set_segment_size", 1, "int(0..65535)");
+  if (FD < 0) Pike_error("Not open\n");
+  o = size;
+  o = fd_setsockopt(FD, IPPROTO_UDP, UDP_SEGMENT, (char *)&o, sizeof(int));
+  THIS->my_errno = errno;
+  pop_n_elems(args);
+  push_int(!o);
+}
+#endif /* UDP_SEGMENT */
+
+
 static int got_udp_event (struct fd_callback_box *box, int event)
 {
   struct udp_storage *u = (struct udp_storage *) box;
@@ -1196,6 +1793,8 @@ void zero_udp(struct object *o)
   THIS->inet_flags = PIKE_INET_FLAG_UDP;
   THIS->type=SOCK_DGRAM;
   THIS->protocol=0;
+  THIS->read_buf = NULL;
+  THIS->read_buf_size = 0;
   /* map_variable handles read_callback and write_callback. */
 }
 
@@ -1760,6 +2359,10 @@ void init_stdio_udp(void)
   ADD_FUNCTION("read",udp_read,
 	       tFunc(tOr(tInt,tVoid),tMap(tStr,tOr(tInt,tStr))),0);
 
+  ADD_FUNCTION("read_many", udp_read_many,
+	       tFunc(tIntPos tOr(tInt,tVoid) tOr(tIntPos,tVoid),
+		     tOr(tArr(tOr(tArr(tStr8),tArr(tInt))),tZero)), 0);
+
   add_integer_constant("MSG_OOB", 1, 0);
 #ifdef MSG_PEEK
   add_integer_constant("MSG_PEEK", 2, 0);
@@ -1768,6 +2371,20 @@ void init_stdio_udp(void)
   ADD_FUNCTION("send",udp_sendto,
 	       tFunc(tStr tOr(tInt,tStr) tStr tOr(tVoid,tInt),tInt),0);
 
+  ADD_FUNCTION("send_many", udp_send_many,
+	       tOr(tFunc(tOr(tZero,tStr) tOr(tInt,tStr) tArr(tStr8)
+			 tOr(tVoid,tInt), tInt),
+		   tFunc(tArr(tStr) tArr(tOr(tInt,tStr)) tArr(tStr8)
+			 tOr(tVoid,tInt), tInt)), 0);
+
+#ifdef UDP_GRO
+  ADD_FUNCTION("enable_gro", udp_enable_gro, tFunc(tOr(tInt01,tVoid),tInt01), 0);
+#endif
+#ifdef UDP_SEGMENT
+  ADD_FUNCTION("set_segment_size", udp_set_segment_size,
+	       tFunc(tIntPos,tInt01), 0);
+#endif
+
   ADD_FUNCTION("connect",udp_connect,
 	       tFunc(tString tOr(tInt,tStr),tInt),0);
 
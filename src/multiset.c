@@ -39,6 +39,11 @@
 #define ENLARGE_SIZE(size) (((size) << 1) + 4)
 #define DO_SHRINK(msd, extra) ((((msd)->size + extra) << 2) + 4 <= (msd)->allocsize)
 
+/* Multisets built from this many elements get their nodes laid out
+ * in order in the data block, so that scans and lookups walk memory
+ * mostly sequentially. */
+#define COMPACT_MIN_SIZE 64
+
 /* For use with TEST_MULTISET: Always goes into the tracking code in
  * the various find functions, as if a destructed index was encountered. */
 /* #define TEST_MULTISET_TRACKING_PATHS */
@@ -486,8 +491,10 @@ static struct multiset_data *copy_multiset_data (struct multiset_data *old)
 /* The first part of the new data block is a verbatim copy of the old
  * one if verbatim is nonzero. This mode also handles link structures
  * that aren't proper trees. If verbatim is zero, the tree is
- * rebalanced, since the operation is already linear. The copy has no
- * refs.
+ * rebalanced, since the operation is already linear, and the nodes
+ * are stored in order from the start of the block. The latter mode
+ * may also be used with the same size to only compact the block. The
+ * copy has no refs.
  *
  * The resize does not change the refs in referenced svalues, so the
  * old block is always freed. The refs and noval_refs are transferred
@@ -509,7 +516,7 @@ static struct multiset_data *resize_multiset_data (struct multiset_data *old,
     if (newsize < old->size)
       Pike_fatal ("Cannot resize multiset_data with %d elements to %"PRINTINT64"d.\n",
 	     old->size, newsize);
-  if (newsize == old->allocsize)
+  if (verbatim && newsize == old->allocsize)
     Pike_fatal ("Unnecessary resize of multiset_data to same size.\n");
 #endif
 
@@ -1164,8 +1171,16 @@ static struct multiset *mkmultiset_2 (struct array *indices,
     node_skipped:;
     }
 
-    UNSET_ONERROR (uwp);
     fix_free_list (new.msd, indices->size);
+
+    if (new.msd->size >= COMPACT_MIN_SIZE && new.msd->size == size) {
+      /* The nodes are linked in the order of the indices array, which
+       * typically isn't sorted. Store them in order instead. */
+      new.node = NULL;
+      new.msd = resize_multiset_data (new.msd, new.msd->allocsize, 0);
+    }
+
+    UNSET_ONERROR (uwp);
   }
 
   l = ba_alloc(&multiset_allocator);
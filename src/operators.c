@@ -2559,6 +2559,7 @@ PMOD_EXPORT void f_minus(INT32 args)
 static int generate_minus(node *n)
 {
   struct compilation *c = THIS_COMPILATION;
+  node **first_arg, **second_arg;
   switch(count_args(CDR(n)))
   {
   case 1:
@@ -2567,8 +2568,25 @@ static int generate_minus(node *n)
     return 1;
 
   case 2:
+    first_arg=my_get_arg(&_CDR(n), 0);
+    second_arg=my_get_arg(&_CDR(n), 1);
+
     do_docode(CDR(n),DO_NOT_COPY_TOPLEVEL);
-    emit0(F_SUBTRACT);
+    if(first_arg[0]->type == float_type_string &&
+       second_arg[0]->type == float_type_string)
+    {
+      emit0(F_SUBTRACT_FLOATS);
+    }
+    else if(first_arg[0]->type && second_arg[0]->type &&
+	    pike_types_le(first_arg[0]->type, int_type_string, 0, 0) &&
+	    pike_types_le(second_arg[0]->type, int_type_string, 0, 0))
+    {
+      emit0(F_SUBTRACT_INTS);
+    }
+    else
+    {
+      emit0(F_SUBTRACT);
+    }
     modify_stack_depth(-1);
     return 1;
   }
@@ -3958,6 +3976,7 @@ PMOD_EXPORT void f_multiply(INT32 args)
 static int generate_multiply(node *n)
 {
   struct compilation *c = THIS_COMPILATION;
+  node **first_arg, **second_arg;
   switch(count_args(CDR(n)))
   {
   case 1:
@@ -3965,8 +3984,25 @@ static int generate_multiply(node *n)
     return 1;
 
   case 2:
+    first_arg=my_get_arg(&_CDR(n), 0);
+    second_arg=my_get_arg(&_CDR(n), 1);
+
     do_docode(CDR(n),0);
-    emit0(F_MULTIPLY);
+    if(first_arg[0]->type == float_type_string &&
+       second_arg[0]->type == float_type_string)
+    {
+      emit0(F_MULTIPLY_FLOATS);
+    }
+    else if(first_arg[0]->type && second_arg[0]->type &&
+	    pike_types_le(first_arg[0]->type, int_type_string, 0, 0) &&
+	    pike_types_le(second_arg[0]->type, int_type_string, 0, 0))
+    {
+      emit0(F_MULTIPLY_INTS);
+    }
+    else
+    {
+      emit0(F_MULTIPLY);
+    }
     modify_stack_depth(-1);
     return 1;
 
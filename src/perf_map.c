@@ -0,0 +1,288 @@
+/*
+|| This file is part of Pike. For copyright information see COPYRIGHT.
+|| Pike is distributed under GPL, LGPL and MPL. See the file COPYING
+|| for more information.
+*/
+
+/*
+ * Symbol information about the machine code generated for Pike
+ * functions, in the formats read by the Linux perf tool.
+ *
+ * The environment variable PIKE_PERF_MAP selects the formats, as a
+ * comma separated list:
+ *
+ *   map      /tmp/perf-<pid>.map, with the address, size and name of
+ *            each function. Read directly by perf report.
+ *
+ *   jitdump  jit-<pid>.dump in $PIKE_JITDUMP_DIR (default /tmp), which
+ *            also contains the code. Requires perf record -k mono and
+ *            perf inject --jit.
+ *
+ * Any other non-zero value selects map.
+ */
+
+#include "global.h"
+#include "program.h"
+#include "stralloc.h"
+#include "pike_memory.h"
+#include "fsort.h"
+#include "perf_map.h"
+
+#ifdef HAVE_PERF_MAP
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define PERF_MAP_TEXT		1
+#define PERF_MAP_JITDUMP	2
+
+#define JITDUMP_MAGIC		0x4A695444
+#define JITDUMP_VERSION		1
+#define JIT_CODE_LOAD		0
+
+#if defined(__x86_64__)
+#define JITDUMP_ELF_MACH	62	/* EM_X86_64 */
+#elif defined(__aarch64__)
+#define JITDUMP_ELF_MACH	183	/* EM_AARCH64 */
+#elif defined(__arm__)
+#define JITDUMP_ELF_MACH	40	/* EM_ARM */
+#elif defined(__i386__)
+#define JITDUMP_ELF_MACH	3	/* EM_386 */
+#elif defined(__riscv)
+#define JITDUMP_ELF_MACH	243	/* EM_RISCV */
+#elif defined(__powerpc64__)
+#define JITDUMP_ELF_MACH	21	/* EM_PPC64 */
+#elif defined(__powerpc__)
+#define JITDUMP_ELF_MACH	20	/* EM_PPC */
+#else
+#define JITDUMP_ELF_MACH	0	/* EM_NONE */
+#endif
+
+struct jitdump_header
+{
+  unsigned INT32 magic;
+  unsigned INT32 version;
+  unsigned INT32 total_size;
+  unsigned INT32 elf_mach;
+  unsigned INT32 pad1;
+  unsigned INT32 pid;
+  UINT64 timestamp;
+  UINT64 flags;
+};
+
+struct jitdump_code_load
+{
+  unsigned INT32 id;
+  unsigned INT32 total_size;
+  UINT64 timestamp;
+  unsigned INT32 pid;
+  unsigned INT32 tid;
+  UINT64 vma;
+  UINT64 code_addr;
+  UINT64 code_size;
+  UINT64 code_index;
+  /* Followed by the NUL-terminated name and the code. */
+};
+
+struct perf_map_function
+{
+  ptrdiff_t offset;
+  struct identifier *id;
+};
+
+static int perf_map_flags = -1;
+static FILE *perf_map_file = NULL;
+static FILE *jitdump_file = NULL;
+static UINT64 jitdump_code_index = 0;
+
+static void init_perf_map_flags(void)
+{
+  const char *env = getenv("PIKE_PERF_MAP");
+
+  perf_map_flags = 0;
+  if (!env || !*env || !strcmp(env, "0")) return;
+
+  if (strstr(env, "jitdump")) perf_map_flags |= PERF_MAP_JITDUMP;
+  if (strstr(env, "map") || !perf_map_flags) perf_map_flags |= PERF_MAP_TEXT;
+}
+
+static UINT64 jitdump_timestamp(void)
+{
+  struct timespec ts;
+  /* Must match the clock used by perf record -k mono. */
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((UINT64)ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void open_perf_map(void)
+{
+  char path[64];
+  sprintf(path, "/tmp/perf-%ld.map", (long)getpid());
+  perf_map_file = fopen(path, "a");
+  if (!perf_map_file) perf_map_flags &= ~PERF_MAP_TEXT;
+}
+
+static void open_jitdump(void)
+{
+  const char *dir = getenv("PIKE_JITDUMP_DIR");
+  struct jitdump_header h;
+  char path[1024];
+  void *marker;
+  int fd;
+
+  if (!dir || !*dir) dir = "/tmp";
+  snprintf(path, sizeof(path), "%s/jit-%ld.dump", dir, (long)getpid());
+
+  fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666);
+  if (fd < 0) goto fail;
+
+  /* perf record finds the dump through this executable mapping. */
+  marker = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC,
+		MAP_PRIVATE, fd, 0);
+  if ((marker == MAP_FAILED) || !(jitdump_file = fdopen(fd, "wb"))) {
+    close(fd);
+    goto fail;
+  }
+
+  memset(&h, 0, sizeof(h));
+  h.magic = JITDUMP_MAGIC;
+  h.version = JITDUMP_VERSION;
+  h.total_size = sizeof(h);
+  h.elf_mach = JITDUMP_ELF_MACH;
+  h.pid = getpid();
+  h.timestamp = jitdump_timestamp();
+  fwrite(&h, sizeof(h), 1, jitdump_file);
+  fflush(jitdump_file);
+  return;
+
+ fail:
+  perf_map_flags &= ~PERF_MAP_JITDUMP;
+}
+
+static void write_function(struct program *p, struct identifier *id,
+			   PIKE_OPCODE_T *code, size_t size)
+{
+  char name[1100];
+  char *file;
+  INT_TYPE line;
+
+  file = low_get_line_plain(code, p, &line, 0);
+  snprintf(name, sizeof(name), "%s (%s:%ld)",
+	   id->name->size_shift ? "<wide>" : id->name->str,
+	   file ? file : "-", (long)line);
+
+  if (perf_map_file) {
+    fprintf(perf_map_file, "%lx %lx %s\n",
+	    (unsigned long)PTR_TO_INT(code), (unsigned long)size, name);
+  }
+
+  if (jitdump_file) {
+    struct jitdump_code_load rec;
+    size_t name_len = strlen(name) + 1;
+
+    rec.id = JIT_CODE_LOAD;
+    rec.total_size = sizeof(rec) + name_len + size;
+    rec.timestamp = jitdump_timestamp();
+    rec.pid = getpid();
+    rec.tid = syscall(SYS_gettid);
+    rec.vma = rec.code_addr = (UINT64)PTR_TO_INT(code);
+    rec.code_size = size;
+    rec.code_index = jitdump_code_index++;
+    fwrite(&rec, sizeof(rec), 1, jitdump_file);
+    fwrite(name, name_len, 1, jitdump_file);
+    fwrite(code, size, 1, jitdump_file);
+  }
+}
+
+static int perf_map_function_cmp(const struct perf_map_function *a,
+				 const struct perf_map_function *b)
+{
+  if (a->offset < b->offset) return -1;
+  return a->offset > b->offset;
+}
+
+/* Write the functions in the machine code of p. */
+static int low_perf_map_program(struct program *p)
+{
+  struct perf_map_function *funs;
+  int num = 0;
+  int e;
+
+  if (!p->num_program || !p->num_identifiers) return 0;
+
+  funs = xalloc(sizeof(struct perf_map_function) * p->num_identifiers);
+  for (e = 0; e < p->num_identifiers; e++) {
+    struct identifier *id = p->identifiers + e;
+    if (IDENTIFIER_IS_PIKE_FUNCTION(id->identifier_flags) &&
+	(id->func.offset >= 0)) {
+      funs[num].offset = id->func.offset;
+      funs[num].id = id;
+      num++;
+    }
+  }
+
+  fsort(funs, num, sizeof(struct perf_map_function),
+	(fsortfun)perf_map_function_cmp);
+
+  for (e = 0; e < num; e++) {
+    ptrdiff_t end = (e + 1 < num) ? funs[e + 1].offset : p->num_program;
+    /* Aliases share the code with the following entry. */
+    if (end == funs[e].offset) continue;
+    write_function(p, funs[e].id, p->program + funs[e].offset,
+		   (end - funs[e].offset) * sizeof(PIKE_OPCODE_T));
+  }
+  free(funs);
+
+  if (perf_map_file) fflush(perf_map_file);
+  if (jitdump_file) fflush(jitdump_file);
+  return num;
+}
+
+/* Called when the machine code of p is final. */
+void perf_map_program(struct program *p)
+{
+  if (perf_map_flags < 0) init_perf_map_flags();
+  if (!perf_map_flags) return;
+
+  if ((perf_map_flags & PERF_MAP_TEXT) && !perf_map_file) open_perf_map();
+  if ((perf_map_flags & PERF_MAP_JITDUMP) && !jitdump_file) open_jitdump();
+
+  low_perf_map_program(p);
+}
+
+/* Write the perf map for all existing programs, and for any programs
+ * compiled later. Returns the number of functions written.
+ */
+PMOD_EXPORT int perf_map_all_programs(void)
+{
+  struct program *p;
+  int res = 0;
+
+  if (perf_map_flags < 0) init_perf_map_flags();
+  if (!perf_map_flags) perf_map_flags = PERF_MAP_TEXT;
+
+  if ((perf_map_flags & PERF_MAP_TEXT) && !perf_map_file) open_perf_map();
+  if ((perf_map_flags & PERF_MAP_JITDUMP) && !jitdump_file) open_jitdump();
+
+  for (p = first_program; p; p = p->next) {
+    if (p->flags & PROGRAM_OPTIMIZED)
+      res += low_perf_map_program(p);
+  }
+  return res;
+}
+
+#else /* !HAVE_PERF_MAP */
+
+void perf_map_program(struct program *UNUSED(p))
+{
+}
+
+PMOD_EXPORT int perf_map_all_programs(void)
+{
+  return 0;
+}
+
+#endif /* HAVE_PERF_MAP */
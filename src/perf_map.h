@@ -0,0 +1,22 @@
+/*
+|| This file is part of Pike. For copyright information see COPYRIGHT.
+|| Pike is distributed under GPL, LGPL and MPL. See the file COPYING
+|| for more information.
+*/
+
+#ifndef PERF_MAP_H
+#define PERF_MAP_H
+
+#include "program.h"
+
+#if defined(PIKE_USE_MACHINE_CODE) && defined(__linux__)
+/* Symbol maps for machine code are supported. */
+#define HAVE_PERF_MAP
+#endif
+
+/* Prototypes begin here */
+void perf_map_program(struct program *p);
+PMOD_EXPORT int perf_map_all_programs(void);
+/* Prototypes end here */
+
+#endif /* PERF_MAP_H */
@@ -108,6 +108,7 @@ struct compilation
   int saved_lock_depth;
 #endif
   struct mapping *resolve_cache;
+  struct mapping *inline_calls;		/* program id: ([ ref: value ]) */
 };
 
 /*
@@ -0,0 +1,20 @@
+/*
+|| This file is part of Pike. For copyright information see COPYRIGHT.
+|| Pike is distributed under GPL, LGPL and MPL. See the file COPYING
+|| for more information.
+*/
+
+#ifndef PIKE_PROBES_H
+#define PIKE_PROBES_H
+
+/* Static probes, see dtrace/dtrace_probes.d. */
+
+#ifdef USE_DTRACE
+#include "dtrace_probes.h"
+#elif defined(USE_SDT)
+#include "dtrace/sdt_probes.h"
+#else
+#include "dtrace/dtrace_probes_disabled.h"
+#endif
+
+#endif /* PIKE_PROBES_H */
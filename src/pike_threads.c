@@ -39,6 +39,7 @@
 #include "pike_cpulib.h"
 #include "pike_compiler.h"
 #include "sprintf.h"
+#include "pike_probes.h"
 
 #include <errno.h>
 #include <math.h>
@@ -475,6 +476,7 @@ PMOD_EXPORT void pike_low_lock_interpreter (DLOC_DECL)
   mt_unlock (&interpreter_lock_wanted);
 
   SET_LOCKING_THREAD;
+  PIKE_INTERPRETER_LOCK();
   USE_DLOC_ARGS();
   THREADS_FPRINTF (1, "Got iplock @ %s:%d\n", DLOC_ARGS_OPT);
 }
@@ -485,6 +487,7 @@ PMOD_EXPORT void pike_low_wait_interpreter (COND_T *cond COMMA_DLOC_DECL)
   THREADS_FPRINTF (1, "Waiting on cond %p without iplock @ %s:%d\n",
                    cond, DLOC_ARGS_OPT);
   UNSET_LOCKING_THREAD;
+  PIKE_INTERPRETER_UNLOCK();
 
   /* FIXME: Should use interpreter_lock_wanted here as well. The
    * problem is that few (if any) thread libs lets us atomically
@@ -492,6 +495,7 @@ PMOD_EXPORT void pike_low_wait_interpreter (COND_T *cond COMMA_DLOC_DECL)
   co_wait (cond, &interpreter_lock);
 
   SET_LOCKING_THREAD;
+  PIKE_INTERPRETER_LOCK();
   THREADS_FPRINTF (1, "Got signal on cond %p with iplock @ %s:%d\n",
                    cond, DLOC_ARGS_OPT);
 }
@@ -505,6 +509,7 @@ PMOD_EXPORT int pike_low_timedwait_interpreter (COND_T *cond,
   THREADS_FPRINTF (1, "Waiting on cond %p without iplock @ %s:%d\n",
                    cond, DLOC_ARGS_OPT);
   UNSET_LOCKING_THREAD;
+  PIKE_INTERPRETER_UNLOCK();
 
   /* FIXME: Should use interpreter_lock_wanted here as well. The
    * problem is that few (if any) thread libs lets us atomically
@@ -512,6 +517,7 @@ PMOD_EXPORT int pike_low_timedwait_interpreter (COND_T *cond,
   res = co_wait_timeout (cond, &interpreter_lock, sec, nsec);
 
   SET_LOCKING_THREAD;
+  PIKE_INTERPRETER_LOCK();
   THREADS_FPRINTF (1, "Got signal on cond %p with iplock @ %s:%d\n",
                    cond, DLOC_ARGS_OPT);
   return res;
@@ -543,6 +549,7 @@ PMOD_EXPORT void pike_unlock_interpreter (DLOC_DECL)
   USE_DLOC_ARGS();
   THREADS_FPRINTF (1, "Releasing iplock @ %s:%d\n", DLOC_ARGS_OPT);
   UNSET_LOCKING_THREAD;
+  PIKE_INTERPRETER_UNLOCK();
   mt_unlock (&interpreter_lock);
 }
 
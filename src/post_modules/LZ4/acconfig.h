@@ -0,0 +1,3 @@
+
+/* Define if you have a working liblz4 */
+#undef HAVE_LIBLZ4
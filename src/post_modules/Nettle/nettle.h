@@ -37,6 +37,10 @@ extern struct program *nettle_hash_program;
 /* Encrypt/decrypt methods are a bit more expensive. */
 #define CIPHER_THREADS_ALLOW_THRESHOLD	1024
 
+/* The batch functions (hash_many() et al) release the lock once for
+   all messages, so the total size is what matters. */
+#define BATCH_THREADS_ALLOW_THRESHOLD	(64 * 1024)
+
 #ifdef HAVE_NETTLE_DSA_H
 #include <nettle/dsa.h>
 #endif
@@ -80,6 +84,9 @@ char *pike_crypt_md5(int pl, const char *const pw,
                      int sl, const char *const salt,
                      int ml, const char *const magic);
 
+struct array;
+size_t check_string8_array(struct array *msgs);
+
 void hash_init(void);
 
 void hash_exit(void);
@@ -0,0 +1,3 @@
+
+/* Define if you have a working libzstd */
+#undef HAVE_LIBZSTD
@@ -35,6 +35,7 @@
 #include "module_support.h"
 #include "bitvector.h"
 #include "sprintf.h"
+#include "perf_map.h"
 
 #include <errno.h>
 #include <fcntl.h>
@@ -3149,6 +3150,7 @@ void optimize_program(struct program *p)
 
   p->flags |= PROGRAM_OPTIMIZED;
   make_program_executable(p);
+  perf_map_program(p);
 }
 
 /* internal function to make the index-table */
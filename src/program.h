@@ -416,6 +416,7 @@ struct program_constant
 #define ID_DYNAMIC_DOT            0x100000 /* #pragma dynamic_dot */
 #define ID_COMPILER_TRACE	  0x200000 /* #pragma compiler_trace */
 #define ID_NO_EXPERIMENTAL_WARNINGS 0x400000 /* #pragma no_experimental_warnings */
+#define ID_NO_INLINE_CALLS	  0x800000 /* #pragma no_inline_calls */
 
 
 /*
@@ -2865,6 +2865,92 @@ static struct array *parse_sprintf_argument_types(PCHARP format,
   return arg_types;
 }
 
+static node *add_sprintf_piece(node *list, node *piece, int *num_pieces)
+{
+  (*num_pieces)++;
+  return list ? mknode(F_ARG_LIST, list, piece) : piece;
+}
+
+static node *add_sprintf_literal(node *list, struct pike_string *fmt,
+				 ptrdiff_t start, ptrdiff_t end,
+				 int *num_pieces)
+{
+  struct pike_string *str;
+  node *piece;
+  if (end <= start) return list;
+  str = make_shared_binary_string(fmt->str + start, end - start);
+  piece = mkstrnode(str);
+  free_string(str);
+  return add_sprintf_piece(list, piece, num_pieces);
+}
+
+/* Converts a call of sprintf() with a constant format that only
+ * contains plain %s and %d directives (besides %%) into a string
+ * addition, if the arguments are known to be strings and ints
+ * respectively. The format then doesn't need to be parsed at
+ * runtime. Returns NULL if the call doesn't qualify.
+ *
+ * NB: The arguments for %s may be zero at runtime even if they are
+ *     typed as strings, and sprintf("%s", 0) is "0". The addition is
+ *     therefore started with "" if the first piece is a %s argument. */
+static node *sprintf_to_add(node *n, struct pike_string *fmt, int num_args)
+{
+  node *ret = NULL;
+  ptrdiff_t i, lit = 0;
+  int arg = 1, num_pieces = 0;
+
+  if (fmt->size_shift) return NULL;
+
+  for (i = 0; i < fmt->len; i++) {
+    node **argp;
+    if (STR0(fmt)[i] != '%') continue;
+    if (++i == fmt->len) return NULL;
+    switch(STR0(fmt)[i]) {
+    case '%':
+      break;
+    case 's':
+      if (!(argp = my_get_arg(&_CDR(n), arg++)) ||
+	  !pike_types_le((*argp)->type, string_type_string, 0, 0))
+	return NULL;
+      break;
+    case 'd':
+      if (!(argp = my_get_arg(&_CDR(n), arg++)) ||
+	  !pike_types_le((*argp)->type, int_type_string, 0, 0))
+	return NULL;
+      break;
+    default:
+      return NULL;
+    }
+  }
+  if (arg != num_args) return NULL;
+
+  arg = 1;
+  for (i = 0; i < fmt->len; i++) {
+    node *piece;
+    int c;
+    if (STR0(fmt)[i] != '%') continue;
+    c = STR0(fmt)[++i];
+    /* The literal text before the directive. For %% it includes the
+     * first %. */
+    ret = add_sprintf_literal(ret, fmt, lit, i - (c != '%'), &num_pieces);
+    lit = i + 1;
+    if (c == '%') continue;
+    if (!ret && (c == 's')) {
+      ret = add_sprintf_piece(ret, mkstrnode(empty_pike_string),
+			      &num_pieces);
+    }
+    piece = *my_get_arg(&_CDR(n), arg++);
+    ADD_NODE_REF(piece);
+    if (c == 'd') piece = mkcastnode(string_type_string, piece);
+    ret = add_sprintf_piece(ret, piece, &num_pieces);
+  }
+  ret = add_sprintf_literal(ret, fmt, lit, fmt->len, &num_pieces);
+
+  if (!ret) return mkstrnode(empty_pike_string);
+  if (num_pieces > 1) return mkefuncallnode("`+", ret);
+  return ret;
+}
+
 static node *optimize_sprintf(node *n)
 {
   node **arg0 = my_get_arg(&_CDR(n), 0);
@@ -2928,6 +3014,9 @@ static node *optimize_sprintf(node *n)
       default: break;
       }
     }
+
+    if (num_args > 0 && (ret = sprintf_to_add(n, fmt, num_args)))
+      return ret;
   }
   /* FIXME: Convert into compile_sprintf(args[0])->format(@args[1..])? */
   return ret;
@@ -53,6 +53,17 @@ static size_t hashkey = 0;
 static unsigned INT32 htable_size=0;
 static struct pike_string **base_table=0;
 static unsigned INT32 num_strings=0;
+
+/* Strings at least this many bytes long are counted separately in
+ * the statistics below. */
+#define LARGE_STRING_BYTES	(64*1024)
+
+/* Statistics for string_status(). */
+static size_t num_strings_linked = 0;	/* New strings in the table. */
+static size_t num_strings_found = 0;	/* Strings that already existed. */
+static size_t num_large_strings_linked = 0;
+static size_t large_strings_linked_bytes = 0;
+static size_t num_strings_resized = 0;	/* Shrunk by realloc. */
 PMOD_EXPORT struct pike_string *empty_pike_string = 0;
 
 /*** Main string hash function ***/
@@ -562,6 +573,7 @@ static void free_string_content(struct pike_string * s)
    case STRING_ALLOC_STATIC:
      break;
    case STRING_ALLOC_MALLOC:
+   case STRING_ALLOC_MALLOC_EXTRA:
      free(s->str);
      break;
    case STRING_ALLOC_BA:
@@ -907,10 +919,16 @@ struct pike_string *low_end_shared_string(struct pike_string *s)
 
   if(s2)
   {
+    num_strings_found++;
     free_string(s);
     s = s2;
     add_ref(s);
   }else{
+    num_strings_linked++;
+    if (((size_t)len << s->size_shift) >= LARGE_STRING_BYTES) {
+      num_large_strings_linked++;
+      large_strings_linked_bytes += (size_t)len << s->size_shift;
+    }
     if (!len) {
       s->string_is_utf8 = 1;
       s->min = s->max = 0;	/* Not really, but... */
@@ -1043,6 +1061,12 @@ PMOD_EXPORT struct pike_string *end_and_resize_shared_string(struct pike_string
   if (len == str->len) {
     return end_shared_string(str);
   }
+  if ((str->flags & STRING_NOT_SHARED) && string_may_modify(str)) {
+    /* Typically a buffer that was only partially filled. Shrink it
+     * instead of copying the data, which may be large. */
+    num_strings_resized++;
+    return end_shared_string(realloc_unlinked_string(str, len));
+  }
   tmp = make_shared_binary_pcharp(MKPCHARP_STR(str),len);
   free_string(str);
   return tmp;
@@ -1360,6 +1384,16 @@ struct pike_string *add_string_status(int verbose)
       string_builder_strcat(&s, "   -\n");
     }
   }
+  string_builder_sprintf(&s,
+                         "\nShared strings created: %lu new, %lu already existing\n"
+                         "Large strings (>= %d bytes) created: %lu, %lu bytes\n"
+                         "Buffers shrunk in place: %lu\n",
+                         (unsigned long)num_strings_linked,
+                         (unsigned long)num_strings_found,
+                         LARGE_STRING_BYTES,
+                         (unsigned long)num_large_strings_linked,
+                         (unsigned long)large_strings_linked_bytes,
+                         (unsigned long)num_strings_resized);
 /*
   string_builder_sprintf(&s, "Searches: %ld    Average search length: %6.3f\n",
                          (long)num_str_searches,
@@ -1685,6 +1719,20 @@ PMOD_EXPORT ptrdiff_t my_quick_strcmp(const struct pike_string *a,
 }
 
 
+/* The number of bytes actually allocated for the str field of a
+ * STRING_ALLOC_MALLOC_EXTRA string that needs nbytes. It is rounded
+ * up to a multiple of between 1/8 and 1/4 of nbytes, so that strings
+ * that are appended to repeatedly only get reallocated now and then. */
+static size_t string_extra_alloc_size(size_t nbytes)
+{
+  size_t step = 16;
+  while ((step << 3) <= nbytes) step <<= 1;
+  return (nbytes + step - 1) & ~(step - 1);
+}
+
+/* NB: For STRING_ALLOC_MALLOC_EXTRA strings, the allocated size is
+ *     derived from a->len, so a->len must be the length the string
+ *     had when it was last allocated or reallocated. */
 struct pike_string *debug_realloc_unlinked_string(struct pike_string *a,
                                                   ptrdiff_t size)
 {
@@ -1704,16 +1752,40 @@ struct pike_string *debug_realloc_unlinked_string(struct pike_string *a,
     free_string_content(a);
     a->alloc_type = STRING_ALLOC_BA;
   }
+  else if( size < a->len )
+  {
+    /* Shrinking. Keep the exact size. */
+    if( string_is_malloced(a) )
+    {
+      s = xrealloc(a->str,nbytes);
+    }
+    else
+    {
+      s = xalloc(nbytes);
+      memcpy(s,a->str,nbytes);
+      free_string_content(a);
+    }
+    a->alloc_type = STRING_ALLOC_MALLOC;
+  }
+  else if( a->alloc_type == STRING_ALLOC_MALLOC_EXTRA )
+  {
+    size_t alloced =
+      string_extra_alloc_size(obytes + (1 << a->size_shift));
+    if( nbytes <= alloced )
+      goto done;
+    s = xrealloc(a->str, string_extra_alloc_size(nbytes));
+  }
   else if( a->alloc_type == STRING_ALLOC_MALLOC)
   {
-    s = xrealloc(a->str,nbytes);
+    s = xrealloc(a->str, string_extra_alloc_size(nbytes));
+    a->alloc_type = STRING_ALLOC_MALLOC_EXTRA;
   }
   else
   {
-    s = xalloc(nbytes);
+    s = xalloc(string_extra_alloc_size(nbytes));
     memcpy(s,a->str,MINIMUM(nbytes,obytes));
     free_string_content(a);
-    a->alloc_type = STRING_ALLOC_MALLOC;
+    a->alloc_type = STRING_ALLOC_MALLOC_EXTRA;
   }
   a->str = s;
 done:
@@ -2435,6 +2507,7 @@ void count_string_types() {
               num_substring ++;
               break;
           case STRING_ALLOC_MALLOC:
+          case STRING_ALLOC_MALLOC_EXTRA:
               num_malloc ++;
               break;
           }
@@ -2463,6 +2536,9 @@ size_t count_memory_in_string(const struct pike_string * s) {
   case STRING_ALLOC_MALLOC:
       size += PIKE_ALIGNTO(((s->len + 1) << s->size_shift), 4);
       break;
+  case STRING_ALLOC_MALLOC_EXTRA:
+      size += string_extra_alloc_size((s->len + 1) << s->size_shift);
+      break;
   case STRING_ALLOC_STATIC:
       break;
   }